@@ -0,0 +1,357 @@
+// Headless benchmarks of the CPU spline and surface code, written as JSON.
+// Only the Vulkan-free sources are needed, e.g. with g++:
+//   g++ -std=c++20 -O2 -Isrc -I<glm> benchmark/SplineBenchmark.cpp src/ArcLengthTable.cpp src/BSplineBasis.cpp src/BezierExtraction.cpp
+//       src/CurveBatchEvaluator.cpp src/CurveFlattener.cpp src/MeshClipper.cpp src/RandomSegments.cpp src/SegmentClipper.cpp src/SplineCurves.cpp src/SplineKernels.cpp
+//       src/SurfaceEvaluationPlan.cpp src/SurfaceMesh.cpp -ltbb -o SplineBenchmark
+// Usage: SplineBenchmark [--out file.json] [--filter substring] [--min-time seconds]
+
+#include "MeshClipper.h"
+#include "RandomSegments.h"
+#include "SegmentClipper.h"
+#include "SplineCurves.h"
+#include "SurfaceMesh.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// GCC would otherwise inline free() into callers whose pointer came from the replaced operator new
+// and report a malloc/free pair it cannot see as mismatched.
+#ifdef _MSC_VER
+#define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+	std::atomic<uint64_t> allocationCount{ 0 };
+	std::atomic<uint64_t> allocatedBytes{ 0 };
+
+	// Written by doNotOptimize(); a volatile store cannot be dropped.
+	volatile const void* sink = nullptr;
+}
+
+// Every replaced form allocates with malloc and frees with free; the array forms forward to these.
+
+BENCHMARK_NOINLINE void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+BENCHMARK_NOINLINE void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+BENCHMARK_NOINLINE void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace
+{
+	using namespace assignment;
+
+	struct Options
+	{
+		std::string outputPath{};
+		std::string filter{};
+		double minTime = 0.2;
+	};
+
+	using Parameters = std::vector<std::pair<std::string, uint32_t>>;
+
+	struct Result
+	{
+		std::string name{};
+		Parameters parameters{};
+		uint64_t iterations = 0;
+		double nsPerOp = 0.0;
+		double itemsPerSecond = 0.0;
+		double allocationsPerOp = 0.0;
+		double bytesPerOp = 0.0;
+	};
+
+	// Runs op until minTime has passed; items is the amount of work per call (samples, indices, ...).
+	class Runner
+	{
+	public:
+		explicit Runner(const Options& options) : options(options) {}
+
+		void run(const std::string& name, const Parameters& parameters, uint64_t items, const std::function<void()>& op)
+		{
+			if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+				return;
+
+			using Clock = std::chrono::steady_clock;
+
+			op();
+
+			uint64_t iterations = 0;
+			const uint64_t allocationsBefore = allocationCount.load();
+			const uint64_t bytesBefore = allocatedBytes.load();
+			const Clock::time_point start = Clock::now();
+			double elapsed = 0.0;
+			for (uint64_t batch = 1; elapsed < options.minTime; batch *= 2)
+			{
+				for (uint64_t i = 0; i < batch; i++)
+					op();
+				iterations += batch;
+				elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+			}
+
+			Result result;
+			result.name = name;
+			result.parameters = parameters;
+			result.iterations = iterations;
+			result.nsPerOp = elapsed * 1e9 / double(iterations);
+			result.itemsPerSecond = double(items) * double(iterations) / elapsed;
+			result.allocationsPerOp = double(allocationCount.load() - allocationsBefore) / double(iterations);
+			result.bytesPerOp = double(allocatedBytes.load() - bytesBefore) / double(iterations);
+			results.push_back(result);
+
+			std::cerr << std::left << std::setw(32) << name << std::setw(48) << describe(parameters)
+				<< std::right << std::setw(14) << std::fixed << std::setprecision(0) << result.nsPerOp << " ns/op\n";
+		}
+
+		std::string toJson() const
+		{
+			std::ostringstream json;
+			json << std::fixed << "{\n\t\"benchmarks\": [\n";
+			for (size_t i = 0; i < results.size(); i++)
+			{
+				const Result& r = results[i];
+				json << "\t\t{ \"name\": \"" << r.name << "\", \"parameters\": { ";
+				for (size_t k = 0; k < r.parameters.size(); k++)
+					json << (k > 0 ? ", " : "") << "\"" << r.parameters[k].first << "\": " << r.parameters[k].second;
+				json << " }, \"iterations\": " << r.iterations
+					<< std::setprecision(1) << ", \"ns_per_op\": " << r.nsPerOp
+					<< ", \"items_per_second\": " << r.itemsPerSecond
+					<< std::setprecision(2) << ", \"allocations_per_op\": " << r.allocationsPerOp
+					<< std::setprecision(1) << ", \"bytes_per_op\": " << r.bytesPerOp
+					<< " }" << (i + 1 < results.size() ? "," : "") << "\n";
+			}
+			json << "\t]\n}\n";
+			return json.str();
+		}
+
+	private:
+		static std::string describe(const Parameters& parameters)
+		{
+			std::string text;
+			for (const auto& [key, value] : parameters)
+				text += key + "=" + std::to_string(value) + " ";
+			return text;
+		}
+
+		const Options& options;
+		std::vector<Result> results;
+	};
+
+	// Keeps the optimizer from dropping a result.
+	template<typename T>
+	void doNotOptimize(const T& value)
+	{
+		sink = &value;
+	}
+
+	std::vector<Vertex> controlPolygon(uint32_t count)
+	{
+		std::vector<Vertex> vertices(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const float x = float(i) / float(count - 1);
+			vertices[i].position = { x, 0.5f * std::sin(12.f * x), 0.f };
+			vertices[i].color = { 1.f, 1.f, 1.f };
+		}
+		return vertices;
+	}
+
+	std::vector<Vertex> controlNet(uint32_t rows, uint32_t cols)
+	{
+		std::vector<Vertex> vertices(size_t(rows) * cols);
+		for (uint32_t i = 0; i < rows; i++)
+		{
+			for (uint32_t j = 0; j < cols; j++)
+			{
+				const float x = float(j) / float(cols - 1);
+				const float z = float(i) / float(rows - 1);
+				vertices[size_t(i) * cols + j].position = { x, 0.3f * std::sin(3.f * x + 5.f * z), z };
+				vertices[size_t(i) * cols + j].color = { 1.f, 1.f, 1.f };
+			}
+		}
+		return vertices;
+	}
+
+	void benchmarkCurves(Runner& runner)
+	{
+		for (uint32_t count : { 8u, 64u, 512u })
+		{
+			const std::vector<Vertex> vertices = controlPolygon(count);
+
+			for (uint32_t degree : { 2u, 3u, 5u })
+			{
+				const std::vector<float> knots = SplineCurves::openedKnots(count, degree + 1);
+				runner.run("curve/openedKnots", { { "count", count }, { "degree", degree } }, count + degree + 1,
+					[&] { doNotOptimize(SplineCurves::openedKnots(count, degree + 1)); });
+
+				for (uint32_t subdivisions : { 100u, 10000u })
+				{
+					runner.run("curve/bspline", { { "count", count }, { "degree", degree }, { "subdivisions", subdivisions } }, subdivisions + 1,
+						[&] { doNotOptimize(SplineCurves::calculateBSpline(vertices, degree, knots, subdivisions)); });
+				}
+
+				runner.run("curve/bsplineArcLength", { { "count", count }, { "degree", degree } }, 1001,
+					[&] { doNotOptimize(SplineCurves::arcLengthBSpline(vertices, degree, knots, 1001)); });
+
+				runner.run("curve/bsplineAdaptive", { { "count", count }, { "degree", degree } }, count,
+					[&] { doNotOptimize(SplineCurves::adaptiveBSpline(vertices, degree, knots, CurveFlattener::Tolerance{})); });
+			}
+
+			for (uint32_t steps : { 10u, 100u })
+			{
+				std::vector<float> taus;
+				for (uint32_t i = 0; i < steps; i++)
+					taus.push_back(float(i + 1) / float(steps + 1));
+
+				runner.run("curve/cubicSpline", { { "count", count }, { "steps", steps } }, (count - 1) * (steps + 1) + 1,
+					[&] { doNotOptimize(SplineCurves::calculateCubicSpline(vertices, glm::vec3(1.f, 0.f, 0.f), glm::vec3(1.f, 0.f, 0.f), taus)); });
+			}
+
+			runner.run("curve/cubicSplineArcLength", { { "count", count } }, 1001,
+				[&] { doNotOptimize(SplineCurves::arcLengthCubicSpline(vertices, glm::vec3(1.f, 0.f, 0.f), glm::vec3(1.f, 0.f, 0.f), 1001)); });
+
+			runner.run("curve/cubicSplineAdaptive", { { "count", count } }, count,
+				[&] { doNotOptimize(SplineCurves::adaptiveCubicSpline(vertices, glm::vec3(1.f, 0.f, 0.f), glm::vec3(1.f, 0.f, 0.f), CurveFlattener::Tolerance{})); });
+		}
+	}
+
+	void benchmarkSurfaces(Runner& runner)
+	{
+		for (uint32_t size : { 8u, 32u, 128u })
+		{
+			for (uint32_t degree : { 3u, 5u })
+			{
+				runner.run("surface/calculateKnots", { { "size", size }, { "degree", degree } }, size + degree + 1,
+					[&] { doNotOptimize(SurfaceMesh::calculateKnots(degree, int(size))); });
+			}
+		}
+
+		for (uint32_t size : { 8u, 32u })
+		{
+			std::vector<Vertex> net = controlNet(size, size);
+
+			for (uint32_t degree : { 3u, 5u })
+			{
+				std::vector<float> knots = SurfaceMesh::calculateKnots(degree, int(size));
+
+				for (uint32_t subdivisions : { 16u, 64u, 256u })
+				{
+					const Parameters parameters = { { "size", size }, { "degree", degree }, { "subdivisions", subdivisions } };
+					const uint64_t samples = uint64_t(subdivisions) * subdivisions;
+
+					runner.run("surface/splineSurface", parameters, samples,
+						[&] { doNotOptimize(SurfaceMesh::calculateSplineSurface(int(degree), int(degree), knots, knots, net, subdivisions)); });
+					runner.run("surface/splineSurfaceParallel", parameters, samples,
+						[&] { doNotOptimize(SurfaceMesh::calculateSplineSurface(int(degree), int(degree), knots, knots, net, subdivisions, true)); });
+					runner.run("surface/bezierSurface", parameters, samples,
+						[&] { doNotOptimize(SurfaceMesh::calculateBezierSurface(degree, degree, knots, knots, net, subdivisions)); });
+				}
+			}
+		}
+
+		for (uint32_t subdivisions : { 16u, 64u, 256u })
+		{
+			std::vector<Vertex> net = controlNet(8, 8);
+			std::vector<float> knots = SurfaceMesh::calculateKnots(3, 8);
+			const std::vector<Vertex> samples = SurfaceMesh::calculateSplineSurface(3, 3, knots, knots, net, subdivisions);
+			const Parameters parameters = { { "subdivisions", subdivisions } };
+			const uint64_t quads = uint64_t(subdivisions - 1) * (subdivisions - 1);
+
+			runner.run("mesh/smoothSurfaceIndices", parameters, quads,
+				[&] { doNotOptimize(SurfaceMesh::smoothSurfaceIndices(subdivisions, subdivisions)); });
+			runner.run("mesh/flatSurface", parameters, quads,
+				[&] { doNotOptimize(SurfaceMesh::flatSurface(samples, subdivisions, subdivisions)); });
+
+			// Part of the surface is inside, so trivial accepts, rejects and cut triangles are all measured.
+			const std::vector<uint32_t> indices = SurfaceMesh::smoothSurfaceIndices(subdivisions, subdivisions);
+			const MeshClipper::Box box{ { 0.25f, -1.f, 0.1f }, { 0.6f, 1.f, 0.8f } };
+			std::vector<Vertex> clippedVertices;
+			std::vector<uint32_t> clippedIndices;
+			runner.run("mesh/clip", parameters, indices.size() / 3,
+				[&] { MeshClipper::clip(samples, indices, box, clippedVertices, clippedIndices); doNotOptimize(clippedIndices); });
+		}
+	}
+
+	void benchmarkSegments(Runner& runner)
+	{
+		for (uint32_t count : { 100u, 10000u, 1000000u })
+		{
+			SegmentClipper::Segments segments;
+			runner.run("random/segments", { { "count", count } }, count,
+				[&] { RandomSegments::generate(count, count, SegmentClipper::Box{}, segments); doNotOptimize(segments); });
+
+			const SegmentClipper::Box box{ { 0.4f, 0.f, 0.f }, { 0.6f, 1.f, 1.f } };
+			SegmentClipper::Segments result;
+			std::vector<uint32_t> indices;
+			runner.run("clip/segments", { { "count", count } }, count,
+				[&] { SegmentClipper::clip(segments, box, result, indices); doNotOptimize(result); });
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument == "--out" && i + 1 < argc)
+			options.outputPath = argv[++i];
+		else if (argument == "--filter" && i + 1 < argc)
+			options.filter = argv[++i];
+		else if (argument == "--min-time" && i + 1 < argc)
+			options.minTime = std::atof(argv[++i]);
+		else
+		{
+			std::cerr << "Usage: SplineBenchmark [--out file.json] [--filter substring] [--min-time seconds]\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	Runner runner(options);
+	benchmarkCurves(runner);
+	benchmarkSurfaces(runner);
+	benchmarkSegments(runner);
+
+	const std::string json = runner.toJson();
+	if (options.outputPath.empty())
+	{
+		std::cout << json;
+		return EXIT_SUCCESS;
+	}
+
+	std::ofstream file(options.outputPath);
+	if (!file)
+	{
+		std::cerr << "Failed to open " << options.outputPath << "\n";
+		return EXIT_FAILURE;
+	}
+	file << json;
+	return EXIT_SUCCESS;
+}
@@ -1,5 +1,16 @@
 del .\shaders\vert.spv
 del .\shaders\frag.spv
+del .\shaders\splineVert.spv
+del .\shaders\splineFrag.spv
+del .\shaders\clippedVert.spv
+del .\shaders\splineClippedVert.spv
+del .\shaders\splineSurfaceComp.spv
+del .\shaders\splineSurfaceFlatComp.spv
+del .\shaders\splinePatchVert.spv
+del .\shaders\splinePatchTesc.spv
+del .\shaders\splinePatchTese.spv
+del .\shaders\thickLineVert.spv
+del .\shaders\thickLineFrag.spv
 
 C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\shader.vert -o .\shaders\vert.spv
 C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\shader.frag -o .\shaders\frag.spv
@@ -7,4 +18,17 @@ C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\shader.frag -o .\shaders\frag.spv
 C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\spline.vert -o .\shaders\splineVert.spv
 C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\spline.frag -o .\shaders\splineFrag.spv
 
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe -DCLIP_PLANES .\shaders\shader.vert -o .\shaders\clippedVert.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe -DCLIP_PLANES .\shaders\spline.vert -o .\shaders\splineClippedVert.spv
+
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\spline_surface.comp -o .\shaders\splineSurfaceComp.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\spline_surface_flat.comp -o .\shaders\splineSurfaceFlatComp.spv
+
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\spline_patch.vert -o .\shaders\splinePatchVert.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\spline_patch.tesc -o .\shaders\splinePatchTesc.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\spline_patch.tese -o .\shaders\splinePatchTese.spv
+
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\thick_line.vert -o .\shaders\thickLineVert.spv
+C:\VulkanSDK\1.3.239.0\Bin\glslc.exe .\shaders\thick_line.frag -o .\shaders\thickLineFrag.spv
+
 echo "Compilation successful"
\ No newline at end of file
@@ -13,8 +13,15 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
 	mat4 projectionMatrix;
 	mat4 viewMatrix;
 	vec3 directionToLight;
+	vec4 clipPlanes[6];
+	uint clipPlaneCount;
 } ubo;
 
+// Compiled a second time with CLIP_PLANES defined for objects cut by the clip planes.
+#ifdef CLIP_PLANES
+out float gl_ClipDistance[6];
+#endif
+
 layout(push_constant) uniform Push {
 	mat4 modelMatrix;
 	mat4 normalMatrix;
@@ -22,9 +29,21 @@ layout(push_constant) uniform Push {
 
 const float AMBIENT = 0.02f;
 
+#ifdef CLIP_PLANES
+void clip(vec4 worldPosition)
+{
+	for (uint i = 0; i < 6; i++)
+		gl_ClipDistance[i] = i < ubo.clipPlaneCount ? dot(ubo.clipPlanes[i], worldPosition) : 1.f;
+}
+#endif
+
 void main()
 {
-	gl_Position = ubo.projectionMatrix * ubo.viewMatrix * push.modelMatrix * vec4(position, 1.f);
+	vec4 worldPosition = push.modelMatrix * vec4(position, 1.f);
+	gl_Position = ubo.projectionMatrix * ubo.viewMatrix * worldPosition;
+#ifdef CLIP_PLANES
+	clip(worldPosition);
+#endif
 
 	vec3 normalWorldSpace = normalize(mat3(push.normalMatrix) * normal);
 
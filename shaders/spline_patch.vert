@@ -0,0 +1,10 @@
+#version 450
+
+// Control points are passed through untouched; the tessellation stages evaluate the surface.
+
+layout(location = 0) in vec3 position;
+
+void main()
+{
+	gl_Position = vec4(position, 1.f);
+}
@@ -0,0 +1,28 @@
+#version 450
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) flat in vec4 segmentPixels;
+
+layout(location = 0) out vec4 outColor;
+
+layout(push_constant) uniform Push {
+	mat4 modelMatrix;
+	vec2 viewportSize;
+	float width;
+} push;
+
+void main()
+{
+	// Distance to the segment, not its line, so the ends come out round.
+	vec2 start = segmentPixels.xy;
+	vec2 toEnd = segmentPixels.zw - start;
+	vec2 toPixel = gl_FragCoord.xy - start;
+	float along = clamp(dot(toPixel, toEnd) / max(dot(toEnd, toEnd), 1e-8f), 0.f, 1.f);
+	float distanceToSegment = length(toPixel - along * toEnd);
+
+	float coverage = clamp(0.5f * push.width + 0.5f - distanceToSegment, 0.f, 1.f);
+	if (coverage <= 0.f)
+		discard;
+
+	outColor = vec4(fragColor, coverage);
+}
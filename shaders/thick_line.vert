@@ -0,0 +1,71 @@
+#version 450
+
+// One instance per segment. The six vertices span a quad around the projected segment, half the
+// width plus one pixel for the anti-aliased edge on every side, including past both ends.
+
+layout(location = 0) in vec3 startPosition;
+layout(location = 1) in vec3 startColor;
+layout(location = 2) in vec3 endPosition;
+layout(location = 3) in vec3 endColor;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) flat out vec4 segmentPixels;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+	vec3 directionToLight;
+} ubo;
+
+layout(push_constant) uniform Push {
+	mat4 modelMatrix;
+	vec2 viewportSize;
+	float width;
+} push;
+
+// Ends behind the camera are moved onto this w before the perspective divide.
+const float MIN_W = 1e-4f;
+
+// x picks the end, y the side of the segment.
+const vec2 CORNERS[6] = vec2[](
+	vec2(0.f, -1.f), vec2(1.f, -1.f), vec2(1.f, 1.f),
+	vec2(0.f, -1.f), vec2(1.f, 1.f), vec2(0.f, 1.f));
+
+vec2 toScreen(vec4 clip)
+{
+	return (clip.xy / clip.w * 0.5f + 0.5f) * push.viewportSize;
+}
+
+void main()
+{
+	mat4 transform = ubo.projectionMatrix * ubo.viewMatrix * push.modelMatrix;
+	vec4 start = transform * vec4(startPosition, 1.f);
+	vec4 end = transform * vec4(endPosition, 1.f);
+
+	if (start.w < MIN_W && end.w < MIN_W)
+	{
+		gl_Position = vec4(0.f);
+		return;
+	}
+	if (start.w < MIN_W)
+		start = mix(start, end, (MIN_W - start.w) / (end.w - start.w));
+	else if (end.w < MIN_W)
+		end = mix(end, start, (MIN_W - end.w) / (start.w - end.w));
+
+	vec2 startPixel = toScreen(start);
+	vec2 endPixel = toScreen(end);
+	vec2 direction = endPixel - startPixel;
+	float segmentLength = length(direction);
+	direction = segmentLength > 1e-4f ? direction / segmentLength : vec2(1.f, 0.f);
+	vec2 side = vec2(-direction.y, direction.x);
+
+	vec2 corner = CORNERS[gl_VertexIndex];
+	float extent = 0.5f * push.width + 1.f;
+	vec2 offset = ((corner.x == 0.f ? -direction : direction) + corner.y * side) * extent;
+
+	vec4 clip = corner.x == 0.f ? start : end;
+	gl_Position = vec4(clip.xy + offset / push.viewportSize * 2.f * clip.w, clip.zw);
+
+	fragColor = corner.x == 0.f ? startColor : endColor;
+	segmentPixels = vec4(startPixel, endPixel);
+}
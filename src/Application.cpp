@@ -1,11 +1,24 @@
 #include "Application.h"
 
+#include "AsyncGeometryBuilder.h"
+#include "BSplineBasis.h"
 #include "Camera.h"
+#include "DeferredReleaseQueue.h"
 #include "SimpleRenderSystem.h"
 #include "LinesRenderSystem.h"
 #include "Line.h"
 #include "KeyboardMovementController.h"
+#include "MeshClipper.h"
 #include "Model.h"
+#include "RandomSegments.h"
+#include "SegmentClipper.h"
+#include "SplineCurves.h"
+#include "SplineSurfaceComputeSystem.h"
+#include "SplineSurfaceTessellationSystem.h"
+#include "SurfaceEvaluationPlan.h"
+#include "SurfaceMesh.h"
+#include "TessellationCache.h"
+#include "ThickLinesRenderSystem.h"
 
 #include "glm/gtx/rotate_vector.hpp"
 #include <Eigen/Dense>
@@ -20,117 +33,15 @@
 #include <iostream>
 #include <format>
 
-#include <random>
-
-namespace
-{
-	std::shared_ptr<assignment::Line> clipLine(
-		assignment::Device& device,
-		std::vector<assignment::Line::Vertex>& lines,
-		float xmin = 0, float xmax = 1,
-		float ymin = 0, float ymax = 1,
-		float zmin = 0, float zmax = 1
-	)
-	{
-		std::shared_ptr<assignment::Line> clippedLine;
-		if (!(
-			(lines[0].position.x <= xmin && lines[1].position.x <= xmin) || (lines[0].position.x >= xmax && lines[1].position.x >= xmax) ||
-			(lines[0].position.y <= ymin && lines[1].position.y <= ymin) || (lines[0].position.y >= ymax && lines[1].position.y >= ymax) ||
-			(lines[0].position.z <= zmin && lines[1].position.z <= zmin) || (lines[0].position.z >= zmax && lines[1].position.z >= zmax)
-			))
-		{
-			float a = lines[1].position.x - lines[0].position.x;
-			float b = lines[1].position.y - lines[0].position.y;
-			float c = lines[1].position.z - lines[0].position.z;
-			for (int i = 0; i <= 1; i++)
-			{
-				if (lines[i].position.x <= xmin)
-				{
-					lines[i].position.y = b / a * (xmin - lines[0].position.x) + lines[0].position.y;
-					lines[i].position.z = c / a * (xmin - lines[0].position.x) + lines[0].position.z;
-					lines[i].position.x = xmin;
-				}
-				else if (lines[i].position.x >= xmax)
-				{
-					lines[i].position.y = b / a * (xmax - lines[0].position.x) + lines[0].position.y;
-					lines[i].position.z = c / a * (xmax - lines[0].position.x) + lines[0].position.z;
-					lines[i].position.x = xmax;
-				}
-				if (lines[i].position.y <= ymin)
-				{
-					lines[i].position.x = a / b * (ymin - lines[0].position.y) + lines[0].position.x;
-					lines[i].position.z = c / b * (ymin - lines[0].position.y) + lines[0].position.z;
-					lines[i].position.y = ymin;
-				}
-				else if (lines[i].position.y >= ymax)
-				{
-					lines[i].position.x = a / b * (ymax - lines[0].position.y) + lines[0].position.x;
-					lines[i].position.z = c / b * (ymax - lines[0].position.y) + lines[0].position.z;
-					lines[i].position.y = ymax;
-				}
-				if (lines[i].position.z <= zmin)
-				{
-					lines[i].position.x = a / c * (zmin - lines[0].position.z) + lines[0].position.x;
-					lines[i].position.y = b / c * (zmin - lines[0].position.z) + lines[0].position.y;
-					lines[i].position.z = zmin;
-				}
-				else if (lines[i].position.z >= zmax)
-				{
-					lines[i].position.x = a / c * (zmax - lines[0].position.z) + lines[0].position.x;
-					lines[i].position.y = b / c * (zmax - lines[0].position.z) + lines[0].position.y;
-					lines[i].position.z = zmax;
-				}
-			}
-		}
-		else return nullptr;
-		clippedLine = assignment::Line::createLineFromVector(device, lines);
-		return clippedLine;
-	}
-
-	struct RandomLine
-	{
-		RandomLine(
-			float xmin, float xmax,
-			float ymin, float ymax,
-			float zmin, float zmax)
-		{
-			std::random_device rd;
-			std::default_random_engine engine(rd());
-			std::uniform_real_distribution<float> xdist(xmin, xmax);
-			std::uniform_real_distribution<float> ydist(ymin, ymax);
-			std::uniform_real_distribution<float> zdist(zmin, zmax);
-
-			x1 = xdist(engine);
-			x2 = xdist(engine);
-			y1 = ydist(engine);
-			y2 = ydist(engine);
-			z1 = zdist(engine);
-			z2 = zdist(engine);
-		}
-
-		float x1, x2, y1, y2, z1, z2;
-	};
-
-	std::vector<RandomLine> createRandomLines(
-		int n,
-		float xmin = 0, float xmax = 1,
-		float ymin = 0, float ymax = 1,
-		float zmin = 0, float zmax = 1
-		)
-	{
-		std::vector<RandomLine> randomLines;
-		for (int i = 0; i < n; i++)
-			randomLines.push_back(RandomLine{ xmin, xmax, ymin, ymax, zmin, zmax });
-		return randomLines;
-	}
-}
-
 namespace assignment
 {
 	struct GlobalUbo {
 		glm::mat4 projectionMatrix;
 		glm::mat4 viewMatrix;
 		glm::vec3 lightDirection = glm::normalize(glm::vec3{ 1.f, -1.f, -1.f });
+		// World space planes; the clipped pipelines drop everything where dot(plane, (position, 1)) < 0.
+		alignas(16) glm::vec4 clipPlanes[6]{};
+		uint32_t clipPlaneCount = 0;
 	};
 
 	Application::Application()
@@ -168,8 +79,11 @@ namespace assignment
 			uboBuffers[i]->map();
 		}
 
+		VkShaderStageFlags uboStages = VK_SHADER_STAGE_VERTEX_BIT;
+		if (device.getEnabledFeatures().tessellationShader)
+			uboStages |= VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
 		auto globalSetLayout = DescriptorSetLayout::Builder(device)
-			.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uboStages)
 			.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
 			.build();
 
@@ -186,6 +100,10 @@ namespace assignment
 
 		SimpleRenderSystem simpleRenderSystem(device, renderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout());
 		LinesRenderSystem linesRenderSystem(device, renderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout());
+		ThickLinesRenderSystem thickLinesRenderSystem(device, renderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout());
+
+		// Replaced primitives are kept here until the frames in flight that draw them have completed.
+		DeferredReleaseQueue releaseQueue(device);
 
 		auto viewerObject = GameObject::createGameObject(); 
 		viewerObject.transform.translation = { 0.f, 0.f, -1.f };
@@ -242,12 +160,14 @@ namespace assignment
 			v.position.y *= -1;
 
 		std::shared_ptr<Line> spline = Line::createLineFromVector(device, splineVertices);
+		const uint32_t controlPolygonIndex = uint32_t(lineObjects.size());
 		auto gameObject = GameObject::createGameObject("SplineBase");
 		gameObject.line = spline;
 		gameObject.transform.scale = glm::vec3(0.7f);
 		lineObjects.push_back(std::move(gameObject));
 
 		spline = Line::calculateCubicSplineEvenlySpaced(device, splineVertices, glm::vec3(1.f), glm::vec3(1.f), 20);
+		const uint32_t cubicSplineIndex = uint32_t(lineObjects.size());
 		gameObject = GameObject::createGameObject("CubicSpline");
 		gameObject.line = spline;
 		gameObject.transform.scale = glm::vec3(0.7f);
@@ -255,8 +175,12 @@ namespace assignment
 
 		int BSplineSubdivisions = 100;
 		int BSplineDegree = 4;
+		bool adaptiveSampling = false;
+		bool arcLengthSampling = false;
+		CurveFlattener::Tolerance curveTolerance{};
 		splineVertices[0].color = { 1.f, 0.f, 1.f };
 		spline = Line::calculateBSplineOpened(device, splineVertices, BSplineDegree, BSplineSubdivisions);
+		const uint32_t bSplineIndex = uint32_t(lineObjects.size());
 		gameObject = GameObject::createGameObject("B-Spline");
 		gameObject.line = spline;
 		gameObject.transform.scale = glm::vec3(0.7f);
@@ -280,58 +204,107 @@ namespace assignment
 		for (auto& v : surfaceVertices)
 			v.color = { 0.7f, 0.5f, 0.6f };
 
+		const uint32_t surfaceControlPointsIndex = uint32_t(lineObjects.size());
 		gameObject = GameObject::createGameObject("Surface control points");
 		gameObject.line = Line::createLineFromVector(device, surfaceVertices);
 		gameObject.transform.scale = glm::vec3(1.f);
 		lineObjects.push_back(std::move(gameObject));
 
 		int degreeU = 3, degreeV = 3;
-		std::vector<float> knotsU = Model::calculateKnots(degreeU, rows);
-		std::vector<float> knotsV = Model::calculateKnots(degreeV, cols);
 		int subdivisions = 200;
-		std::vector<Model::Vertex> BSplineSurfaceV = Model::calculateSplineSurface(degreeU, degreeV, knotsU, knotsV, surfaceVertices, subdivisions);
+		SplineSurfaceComputeSystem splineSurface(device, releaseQueue, rows, cols, degreeU, degreeV, subdivisions);
 
 		gameObject = GameObject::createGameObject("Spline Surface");
-		gameObject.model = Model::createFlatSurfaceFromVector(device, BSplineSurfaceV, subdivisions, subdivisions);
+		gameObject.model = splineSurface.getModel();
 		gameObject.transform.scale = glm::vec3(1.f);
 		gameObjects.push_back(std::move(gameObject));
 		bool rebuildSplineSurface = true;
+		std::vector<uint32_t> movedSurfaceVertices;
+
+		// Uploaded splines and surfaces by their inputs, so going back to earlier settings skips the rebuild.
+		int tessellationCacheBudget = 64;
+		TessellationCache tessellationCache(releaseQueue, VkDeviceSize(tessellationCacheBudget) << 20);
+		TessellationCache::Key computedSurfaceKey{};
+
+		// Spline rebuilds run on a worker and are swapped in at the start of a frame once uploaded.
+		AsyncGeometryBuilder geometryBuilder(device);
+
+		// Bicubic surface drawn from the control net with hardware tessellation instead of the sample grid,
+		// on devices with tessellation shaders. Other degrees keep using the grid.
+		std::unique_ptr<SplineSurfaceTessellationSystem> surfaceTessellationSystem;
+		if (device.getEnabledFeatures().tessellationShader)
+			surfaceTessellationSystem = std::make_unique<SplineSurfaceTessellationSystem>(
+				device, renderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout(), rows, cols, surfaceVertices);
+		auto tessellatedSurface = GameObject::createGameObject("Tessellated Spline Surface");
+		tessellatedSurface.transform.scale = glm::vec3(1.f);
+		tessellatedSurface.visible = false;
+		bool tessellateSurface = false;
+		// Whether the tessellated surface is the one shown in place of the grid.
+		bool surfaceTessellated = false;
+		float pixelsPerSegment = surfaceTessellationSystem ? surfaceTessellationSystem->getPixelsPerSegment() : 1.f;
+
+
+		// Random lines come from a seed, so the same set can be generated again at any size.
+		int randomLineCount = 100;
+		int randomLineSeed = 1;
+		SegmentClipper::Segments randomSegments;
+
+		// The random lines and their clipped parts share one vertex buffer; the clipped group is rewritten whenever the clip box changes.
+		SegmentClipper::Box clipBox{ { 0.4f, 0.f, 0.f }, { 0.6f, 1.f, 1.f } };
+		SegmentClipper::Segments clippedSegments;
+		std::vector<uint32_t> clippedSegmentIndices;
+		bool reclip = true;
+
+		std::shared_ptr<LineBatch> randomLinesBatch;
+		uint32_t clippedRandomLinesGroup = 0, randomLinesGroup = 0;
+		bool showRandomLines = true, showClippedRandomLines = true;
+		bool thickRandomLines = false;
+		float randomLineWidth = thickLinesRenderSystem.getWidth();
+
+		const uint32_t randomLinesIndex = uint32_t(lineObjects.size());
+		gameObject = GameObject::createGameObject("Random lines");
+		gameObject.transform.scale = { 1.f };
+		lineObjects.push_back(std::move(gameObject));
 
-
-		float xmin = 0.4f, xmax = 0.6f, ymin = 0, ymax = 1, zmin = 0, zmax = 1;
-		std::vector<RandomLine> randomLines = createRandomLines(100);
-
-		for (const auto& rl : randomLines)
+		// On the GPU the clip box only changes the clip planes in the UBO: the random lines and the meshes are
+		// drawn with clip distances, nothing is clipped or uploaded on the CPU.
+		const bool clipDistanceSupported = device.getEnabledFeatures().shaderClipDistance;
+		bool gpuClipping = false;
+		auto applyClippingMode = [&]
 		{
-			std::vector<Line::Vertex> randomLineVertices(2);
-			randomLineVertices[0].position = { rl.x1, rl.y1, rl.z1 };
-			randomLineVertices[0].color = { 1.f, 1.f, 0.f };
-			randomLineVertices[1].position = { rl.x2, rl.y2, rl.z2 };
-			randomLineVertices[1].color = { 1.f, 1.f, 0.f };
-
-			auto clippedRandomLine = clipLine(device, randomLineVertices, xmin, xmax, ymin, ymax, zmin, zmax);
-			if (!clippedRandomLine) continue;
-
-			gameObject = GameObject::createGameObject("crl");
-			gameObject.transform.scale = { 1.f };
-			gameObject.line = clippedRandomLine;
-			lineObjects.push_back(std::move(gameObject));
-		}
-
-		for (const auto& rl : randomLines)
+			randomLinesBatch->getGroup(randomLinesGroup).visible = gpuClipping || showRandomLines;
+			randomLinesBatch->getGroup(clippedRandomLinesGroup).visible = !gpuClipping && showClippedRandomLines;
+			lineObjects[randomLinesIndex].clipped = gpuClipping;
+			for (auto& obj : gameObjects)
+				obj.clipped = gpuClipping;
+		};
+		size_t cutSurfaceTriangles = 0;
+
+		auto generateRandomLines = [&]
 		{
-			std::vector<Line::Vertex> randomLineVertices(2);
-			randomLineVertices[0].position = { rl.x1, rl.y1, rl.z1 };
-			randomLineVertices[0].color = { 1.f, 0.f, 0.f };
-			randomLineVertices[1].position = { rl.x2, rl.y2, rl.z2 };
-			randomLineVertices[1].color = { 1.f, 0.f, 0.f };
+			RandomSegments::generate(uint64_t(randomLineSeed), uint32_t(randomLineCount), SegmentClipper::Box{}, randomSegments);
 
+			std::vector<LineBatch::Vertex> randomLineVertices(2 * size_t(randomSegments.size()));
+			for (uint32_t i = 0; i < randomSegments.size(); i++)
+			{
+				randomLineVertices[2 * i].position = { randomSegments.x0[i], randomSegments.y0[i], randomSegments.z0[i] };
+				randomLineVertices[2 * i].color = { 1.f, 0.f, 0.f };
+				randomLineVertices[2 * i + 1].position = { randomSegments.x1[i], randomSegments.y1[i], randomSegments.z1[i] };
+				randomLineVertices[2 * i + 1].color = { 1.f, 0.f, 0.f };
+			}
 
-			gameObject = GameObject::createGameObject("rl");
-			gameObject.transform.scale = { 1.f };
-			gameObject.line = Line::createLineFromVector(device, randomLineVertices);
-			lineObjects.push_back(std::move(gameObject));
-		}
+			LineBatch::Builder randomLinesBuilder;
+			clippedRandomLinesGroup = randomLinesBuilder.addGroup("crl", {}, uint32_t(randomLineVertices.size()));
+			randomLinesGroup = randomLinesBuilder.addGroup("rl", randomLineVertices);
+
+			// The old batch may still be drawn by a frame in flight.
+			releaseQueue.retire(std::move(lineObjects[randomLinesIndex].lineBatch));
+			randomLinesBatch = std::make_shared<LineBatch>(device, randomLinesBuilder);
+			lineObjects[randomLinesIndex].lineBatch = randomLinesBatch;
+			applyClippingMode();
+			reclip = true;
+		};
+		generateRandomLines();
 
 		/* draw normals
 		std::vector<uint32_t> indices;
@@ -398,6 +371,8 @@ namespace assignment
 			//camera.setOrthographicProjection(-aspect, -1, -1, aspect, 1, 30);
 			camera.setPerspecitveProjection(glm::radians(45.f), aspect, 0.1f, 10.f);
 
+			geometryBuilder.update();
+
 			if (auto commandBuffer = renderer.beginFrame())
 			{
 				int frameIndex = renderer.getFrameIndex();
@@ -414,6 +389,17 @@ namespace assignment
 				ubo.projectionMatrix = camera.getProjection();
 				ubo.viewMatrix = camera.getView();
 				ubo.lightDirection = glm::vec3(1.f, -1.f, -1.f);
+				if (gpuClipping)
+				{
+					for (int axis = 0; axis < 3; axis++)
+					{
+						ubo.clipPlanes[2 * axis][axis] = 1.f;
+						ubo.clipPlanes[2 * axis].w = -clipBox.min[axis];
+						ubo.clipPlanes[2 * axis + 1][axis] = -1.f;
+						ubo.clipPlanes[2 * axis + 1].w = clipBox.max[axis];
+					}
+					ubo.clipPlaneCount = 6;
+				}
 
 				uboBuffers[frameIndex]->writeToBuffer(&ubo);
 				uboBuffers[frameIndex]->flush();
@@ -437,6 +423,7 @@ namespace assignment
 							vertexCount = 2;
 						}
 						splineVertices.resize(vertexCount);
+						BSplineDegree = std::min(BSplineDegree, vertexCount);
 						rebuildSpline = true;
 					}
 
@@ -454,8 +441,27 @@ namespace assignment
 						}
 					}
 
-					if (ImGui::InputInt("B-Spline subdivisions", &BSplineSubdivisions)) rebuildSpline = true;
-					if (ImGui::InputInt("B-Spline degree", &BSplineDegree, 1, 3)) rebuildSpline = true;
+					if (ImGui::InputInt("B-Spline subdivisions", &BSplineSubdivisions))
+					{
+						BSplineSubdivisions = std::max(BSplineSubdivisions, 1);
+						rebuildSpline = true;
+					}
+					if (ImGui::InputInt("B-Spline degree", &BSplineDegree, 1, 3))
+					{
+						BSplineDegree = std::clamp<int>(BSplineDegree, 1, std::min<int>(vertexCount, BSplineBasis::MAX_DEGREE + 1));
+						rebuildSpline = true;
+					}
+					if (ImGui::Checkbox("Adaptive sampling", &adaptiveSampling))
+						rebuildSpline = true;
+					if (!adaptiveSampling && ImGui::Checkbox("Arc length sampling", &arcLengthSampling))
+						rebuildSpline = true;
+					if (adaptiveSampling)
+					{
+						if (ImGui::DragFloat("Chord tolerance", &curveTolerance.chord, 0.0001f, 0.f, 0.1f, "%.4f"))
+							rebuildSpline = true;
+						if (ImGui::SliderAngle("Angle tolerance", &curveTolerance.angle, 0.f, 90.f))
+							rebuildSpline = true;
+					}
 
 					bool ph1, ph2, ph3;
 					if (ImGui::Checkbox("Show base line", &ph1))
@@ -490,20 +496,87 @@ namespace assignment
 
 					if (rebuildSpline)
 					{
+						// Each line keeps its previous version on screen until the new one is uploaded.
+						auto rebuildLine = [&](uint32_t index, const TessellationCache::Key& key, AsyncGeometryBuilder::Build build)
+						{
+							if (std::shared_ptr<Line> line = tessellationCache.find<Line>(key))
+							{
+								geometryBuilder.cancel(index);
+								releaseQueue.retire(std::move(lineObjects[index].line));
+								lineObjects[index].line = line;
+								return;
+							}
+							geometryBuilder.post(index, std::move(build), [&, index, key](std::shared_ptr<GraphicsPrimitive> primitive)
+							{
+								tessellationCache.insert(key, primitive);
+								releaseQueue.retire(std::move(lineObjects[index].line));
+								lineObjects[index].line = std::static_pointer_cast<Line>(primitive);
+							});
+						};
+
 						for (auto& v : splineVertices)
 							v.color = { 1.f, 0.f, 0.f };
-						spline = Line::createLineFromVector(device, splineVertices);
-						lineObjects[3].line = spline;
+						rebuildLine(controlPolygonIndex, TessellationCache::makeKey("ControlPolygon", splineVertices),
+							[this, vertices = splineVertices] { return Line::createDeferredLineFromVector(device, vertices); });
 
 						for (auto& v : splineVertices)
 							v.color = { 0.f, 1.f, 0.f };
-						spline = Line::calculateCubicSplineEvenlySpaced(device, splineVertices, glm::vec3(1.f), glm::vec3(1.f), 20);
-						lineObjects[4].line = spline;
+						if (adaptiveSampling)
+						{
+							const TessellationCache::Key key = TessellationCache::makeKey("CubicSplineAdaptive", splineVertices,
+								curveTolerance.chord, curveTolerance.angle, curveTolerance.minDepth, curveTolerance.maxDepth);
+							rebuildLine(cubicSplineIndex, key, [this, vertices = splineVertices, curveTolerance]
+							{
+								return Line::createDeferredLineFromVector(device, SplineCurves::adaptiveCubicSpline(vertices, glm::vec3(1.f), glm::vec3(1.f), curveTolerance));
+							});
+						}
+						else if (arcLengthSampling)
+						{
+							// As many points as the evenly spaced version below.
+							const uint32_t count = uint32_t(splineVertices.size() - 1) * 21 + 1;
+							const TessellationCache::Key key = TessellationCache::makeKey("CubicSplineArcLength", splineVertices, count);
+							rebuildLine(cubicSplineIndex, key, [this, vertices = splineVertices, count]
+							{
+								return Line::createDeferredLineFromVector(device, SplineCurves::arcLengthCubicSpline(vertices, glm::vec3(1.f), glm::vec3(1.f), count));
+							});
+						}
+						else
+						{
+							const TessellationCache::Key key = TessellationCache::makeKey("CubicSpline", splineVertices, 20);
+							rebuildLine(cubicSplineIndex, key, [this, vertices = splineVertices]
+							{
+								return Line::createDeferredLineFromVector(device, SplineCurves::calculateCubicSpline(vertices, glm::vec3(1.f), glm::vec3(1.f), SplineCurves::evenlySpacedTaus(20)));
+							});
+						}
 
 						for (auto& v : splineVertices)
 							v.color = { 1.f, 0.f, 1.f };
-						spline = Line::calculateBSplineOpened(device, splineVertices, BSplineDegree, BSplineSubdivisions);
-						lineObjects[5].line = spline;
+						const std::vector<float> knots = SplineCurves::openedKnots(uint32_t(splineVertices.size()), BSplineDegree);
+						if (adaptiveSampling)
+						{
+							const TessellationCache::Key key = TessellationCache::makeKey("BSplineAdaptive", splineVertices, BSplineDegree, knots,
+								curveTolerance.chord, curveTolerance.angle, curveTolerance.minDepth, curveTolerance.maxDepth);
+							rebuildLine(bSplineIndex, key, [this, vertices = splineVertices, degree = BSplineDegree, knots, curveTolerance]
+							{
+								return Line::createDeferredLineFromVector(device, SplineCurves::adaptiveBSpline(vertices, degree - 1, knots, curveTolerance));
+							});
+						}
+						else if (arcLengthSampling)
+						{
+							const TessellationCache::Key key = TessellationCache::makeKey("BSplineArcLength", splineVertices, BSplineDegree, knots, BSplineSubdivisions);
+							rebuildLine(bSplineIndex, key, [this, vertices = splineVertices, degree = BSplineDegree, knots, subdivisions = BSplineSubdivisions]
+							{
+								return Line::createDeferredLineFromVector(device, SplineCurves::arcLengthBSpline(vertices, degree - 1, knots, subdivisions + 1));
+							});
+						}
+						else
+						{
+							const TessellationCache::Key key = TessellationCache::makeKey("BSpline", splineVertices, BSplineDegree, knots, BSplineSubdivisions);
+							rebuildLine(bSplineIndex, key, [this, vertices = splineVertices, degree = BSplineDegree, knots, subdivisions = BSplineSubdivisions]
+							{
+								return Line::createDeferredLineFromVector(device, SplineCurves::calculateBSpline(vertices, degree - 1, knots, subdivisions));
+							});
+						}
 						rebuildSpline = false;
 					}
 				}
@@ -520,22 +593,26 @@ namespace assignment
 								(float*)&surfaceVertices[i].position,
 								0.01f))
 							{
-								rebuildSplineSurface = true;
+								movedSurfaceVertices.push_back(i);
 							}
 						}
 					}
 
 					if (ImGui::InputInt("Degree in U direction", &degreeU))
 					{
-						degreeU = std::clamp<uint32_t>(degreeU, 0, rows - 1);
+						degreeU = std::clamp<uint32_t>(degreeU, 0, std::min<uint32_t>(rows - 1, SplineSurfaceComputeSystem::MAX_DEGREE));
 						rebuildSplineSurface = true;
 					}
 					if (ImGui::InputInt("Degree in V direction", &degreeV))
 					{
-						degreeV = std::clamp<uint32_t>(degreeV, 0, cols - 1);
+						degreeV = std::clamp<uint32_t>(degreeV, 0, std::min<uint32_t>(cols - 1, SplineSurfaceComputeSystem::MAX_DEGREE));
+						rebuildSplineSurface = true;
+					}
+					if (ImGui::InputInt("Subdivisions", &subdivisions))
+					{
+						subdivisions = std::max(subdivisions, 2);
 						rebuildSplineSurface = true;
 					}
-					if (ImGui::InputInt("Subdivisions", &subdivisions)) rebuildSplineSurface = true;
 
 					bool ph1, ph2;
 					if (ImGui::Checkbox("Show surface control points", &ph1))
@@ -549,60 +626,194 @@ namespace assignment
 					};
 					if (ImGui::Checkbox("Show spline surface", &ph2))
 					{
-						for (uint32_t i = 0; i < lineObjects.size(); i++)
-							if (gameObjects[i].getName() == "Spline Surface")
+						if (surfaceTessellated)
+							tessellatedSurface.changeVisibility();
+						else
+							for (uint32_t i = 0; i < gameObjects.size(); i++)
+								if (gameObjects[i].getName() == "Spline Surface")
+								{
+									gameObjects[i].changeVisibility();
+									break;
+								}
+					};
+					if (surfaceTessellationSystem)
+					{
+						const bool bicubic = degreeU == 3 && degreeV == 3;
+						if (bicubic)
+							ImGui::Checkbox("Hardware tessellation (bicubic)", &tessellateSurface);
+						else
+							ImGui::Text("Hardware tessellation needs degree 3 in u and v");
+
+						const bool tessellate = tessellateSurface && bicubic;
+						if (tessellate != surfaceTessellated)
+						{
+							for (auto& go : gameObjects)
 							{
-								gameObjects[i].changeVisibility();
-								break;
+								if (go.getName() == "Spline Surface")
+								{
+									std::swap(go.visible, tessellatedSurface.visible);
+									break;
+								}
 							}
-					};
+							surfaceTessellated = tessellate;
+						}
+						if (surfaceTessellated && ImGui::DragFloat("Pixels per segment", &pixelsPerSegment, 0.1f, 1.f, 64.f))
+							surfaceTessellationSystem->setPixelsPerSegment(pixelsPerSegment);
+					}
 
 					ImGui::End();
 
-					if (rebuildSplineSurface)
+					if (rebuildSplineSurface || !movedSurfaceVertices.empty())
 					{
 						for (auto& v : surfaceVertices)
 							v.color = { 1.f, 1.f, 0.f };
-						lineObjects[6].line = Line::createLineFromVector(device, surfaceVertices);
-
-						knotsU = Model::calculateKnots(degreeU, rows);
-						knotsV = Model::calculateKnots(degreeV, cols);
+						// The control net stays on screen until its new version is uploaded, like the curve lines.
+						geometryBuilder.post(surfaceControlPointsIndex,
+							[this, vertices = surfaceVertices] { return Line::createDeferredLineFromVector(device, vertices); },
+							[&](std::shared_ptr<GraphicsPrimitive> primitive)
+							{
+								releaseQueue.retire(std::move(lineObjects[surfaceControlPointsIndex].line));
+								lineObjects[surfaceControlPointsIndex].line = std::static_pointer_cast<Line>(primitive);
+							});
 
 						surfaceVertices[0].color = { 0.7f, 0.5f, 0.6f };
-						BSplineSurfaceV = Model::calculateSplineSurface(degreeU, degreeV, knotsU, knotsV, surfaceVertices, subdivisions);
+						const TessellationCache::Key surfaceKey = TessellationCache::makeKey("SplineSurface", surfaceVertices, degreeU, degreeV,
+							SurfaceMesh::calculateKnots(degreeU, rows), SurfaceMesh::calculateKnots(degreeV, cols), subdivisions);
+						std::shared_ptr<Model> surfaceModel = tessellationCache.find<Model>(surfaceKey);
+						if (!surfaceModel)
+						{
+							// The compute system writes into its current Model, so the entry that Model was cached
+							// under goes stale; new parameters get a new Model and leave the old entry intact.
+							if (splineSurface.getDegreeU() != uint32_t(degreeU) ||
+								splineSurface.getDegreeV() != uint32_t(degreeV) ||
+								splineSurface.getSubdivisions() != uint32_t(subdivisions))
+								splineSurface.setParameters(degreeU, degreeV, subdivisions);
+							else
+								tessellationCache.erase(computedSurfaceKey);
+
+							splineSurface.updateControlPoints(frameIndex, surfaceVertices);
+							splineSurface.dispatch(commandBuffer, frameIndex);
+							surfaceModel = splineSurface.getModel();
+							tessellationCache.insert(surfaceKey, surfaceModel);
+							computedSurfaceKey = surfaceKey;
+						}
 						for (auto& go : gameObjects)
 						{
 							if (go.getName() == "Spline Surface")
 							{
-								go.model = Model::createFlatSurfaceFromVector(device, BSplineSurfaceV, subdivisions, subdivisions);
+								releaseQueue.retire(std::move(go.model));
+								go.model = surfaceModel;
 								break;
 							}
 						}
+						if (surfaceTessellationSystem && !movedSurfaceVertices.empty())
+							surfaceTessellationSystem->updateControlPoints(surfaceVertices);
 
+						movedSurfaceVertices.clear();
 						rebuildSplineSurface = false;
 					}
 				}
 
+				{
+					ImGui::Begin("Tessellation cache");
+					if (ImGui::SliderInt("Budget (MiB)", &tessellationCacheBudget, 1, 1024))
+						tessellationCache.setBudget(VkDeviceSize(tessellationCacheBudget) << 20);
+					const TessellationCache::Statistics& statistics = tessellationCache.getStatistics();
+					ImGui::Text(std::format("Entries: {}, {:.2f} MiB", tessellationCache.size(), double(tessellationCache.getMemoryUsage()) / double(1 << 20)).c_str());
+					ImGui::Text(std::format("Hits: {}, misses: {}, evictions: {}", statistics.hits, statistics.misses, statistics.evictions).c_str());
+					if (ImGui::Button("Clear"))
+						tessellationCache.clear();
+					ImGui::End();
+				}
+
+				{
+					ImGui::Begin("GPU memory");
+					const MemoryAllocator::Statistics memory = device.getMemoryStatistics();
+					ImGui::Text(std::format("Allocations: {} in {} blocks, {} dedicated", memory.allocationCount, memory.blockCount, memory.dedicatedCount).c_str());
+					ImGui::Text(std::format("Blocks: {:.2f} MiB, {:.2f} MiB reserved, {:.2f} MiB used",
+						double(memory.blockBytes) / double(1 << 20), double(memory.reservedBytes) / double(1 << 20),
+						double(memory.usedBytes - memory.dedicatedBytes) / double(1 << 20)).c_str());
+					ImGui::Text(std::format("Dedicated: {:.2f} MiB", double(memory.dedicatedBytes) / double(1 << 20)).c_str());
+					ImGui::End();
+				}
+
 				{
 					ImGui::Begin("Random lines clipping");
 
-					bool b1, b2;
-					if (ImGui::Checkbox("Show unclipped random lines", &b1))
+					if (clipDistanceSupported && ImGui::Checkbox("Clip on GPU (lines and meshes)", &gpuClipping))
+						applyClippingMode();
+					if (!gpuClipping)
 					{
-						for (uint32_t i = 0; i < lineObjects.size(); i++)
-							if (lineObjects[i].getName() == "rl")
-							{
-								lineObjects[i].changeVisibility();
-							}
-					};
-					if (ImGui::Checkbox("Show clipped random lines", &b2))
+						if (ImGui::Checkbox("Show unclipped random lines", &showRandomLines))
+							applyClippingMode();
+						if (ImGui::Checkbox("Show clipped random lines", &showClippedRandomLines))
+							applyClippingMode();
+					}
+					// Thick lines are drawn by their own system, so the line list version is hidden meanwhile.
+					if (ImGui::Checkbox("Thick lines", &thickRandomLines))
+						lineObjects[randomLinesIndex].visible = !thickRandomLines;
+					if (thickRandomLines && ImGui::SliderFloat("Line width (px)", &randomLineWidth, 1.f, 32.f))
+						thickLinesRenderSystem.setWidth(randomLineWidth);
+					ImGui::InputInt("Random line count", &randomLineCount, 100, 10000);
+					randomLineCount = std::clamp(randomLineCount, 1, 1000000);
+					ImGui::InputInt("Seed", &randomLineSeed);
+					if (ImGui::Button("Generate"))
+						generateRandomLines();
+
+					reclip |= ImGui::DragFloat3("Clip box min", &clipBox.min.x, 0.01f);
+					reclip |= ImGui::DragFloat3("Clip box max", &clipBox.max.x, 0.01f);
+
+					if (reclip && !gpuClipping)
 					{
-						for (uint32_t i = 0; i < lineObjects.size(); i++)
-							if (lineObjects[i].getName() == "crl")
-							{
-								lineObjects[i].changeVisibility();
-							}
-					};
+						SegmentClipper::clip(randomSegments, clipBox, clippedSegments, clippedSegmentIndices);
+
+						std::vector<LineBatch::Vertex> clippedVertices(2 * size_t(clippedSegments.size()));
+						for (uint32_t i = 0; i < clippedSegments.size(); i++)
+						{
+							clippedVertices[2 * i].position = { clippedSegments.x0[i], clippedSegments.y0[i], clippedSegments.z0[i] };
+							clippedVertices[2 * i].color = { 1.f, 1.f, 0.f };
+							clippedVertices[2 * i + 1].position = { clippedSegments.x1[i], clippedSegments.y1[i], clippedSegments.z1[i] };
+							clippedVertices[2 * i + 1].color = { 1.f, 1.f, 0.f };
+						}
+						randomLinesBatch->setGroupVertices(commandBuffer, frameIndex, clippedRandomLinesGroup, clippedVertices);
+						reclip = false;
+					}
+					if (!gpuClipping)
+						ImGui::Text(std::format("Clipped lines: {} of {}", clippedSegments.size(), randomSegments.size()).c_str());
+
+					// A copy of the spline surface cut to the box on the CPU, placed next to the original.
+					if (ImGui::Button("Cut surface to box"))
+					{
+						const std::vector<Model::Vertex> samples = SurfaceEvaluationPlan(degreeU, degreeV,
+							SurfaceMesh::calculateKnots(degreeU, rows), SurfaceMesh::calculateKnots(degreeV, cols), subdivisions).evaluate(surfaceVertices, true);
+						Model::Builder cutSurfaceBuilder;
+						MeshClipper::clip(samples, SurfaceMesh::smoothSurfaceIndices(subdivisions, subdivisions), clipBox,
+							cutSurfaceBuilder.vertices, cutSurfaceBuilder.indices);
+						cutSurfaceTriangles = cutSurfaceBuilder.indices.size() / 3;
+
+						auto cutSurface = std::find_if(gameObjects.begin(), gameObjects.end(), [](GameObject& go) { return go.getName() == "Cut surface"; });
+						if (cutSurface == gameObjects.end())
+						{
+							gameObject = GameObject::createGameObject("Cut surface");
+							gameObject.transform.translation = { 1.2f, 0.f, 0.f };
+							gameObject.transform.scale = glm::vec3(1.f);
+							gameObject.clipped = gpuClipping;
+							gameObjects.push_back(std::move(gameObject));
+							cutSurface = gameObjects.end() - 1;
+						}
+						cutSurface->visible = !cutSurfaceBuilder.indices.empty();
+						if (cutSurface->visible)
+						{
+							// The old model may still be drawn by a frame in flight.
+							releaseQueue.retire(std::move(cutSurface->model));
+							cutSurface->model = std::make_shared<Model>(device, cutSurfaceBuilder);
+						}
+					}
+					if (cutSurfaceTriangles > 0)
+					{
+						ImGui::SameLine();
+						ImGui::Text(std::format("{} triangles", cutSurfaceTriangles).c_str());
+					}
 
 					ImGui::End();
 				}
@@ -613,12 +824,17 @@ namespace assignment
 				// render
 				renderer.beginSwapChainRenderPass(commandBuffer);
 				simpleRenderSystem.renderGameObjects(frameInfo, gameObjects);
+				if (surfaceTessellationSystem)
+					surfaceTessellationSystem->render(frameInfo, tessellatedSurface, renderer.getSwapChainExtent());
 				linesRenderSystem.renderLineObjects(frameInfo, lineObjects);
+				if (thickRandomLines)
+					thickLinesRenderSystem.render(frameInfo, lineObjects[randomLinesIndex], renderer.getSwapChainExtent());
 
 				ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
 				renderer.endSwapChainRenderPass(commandBuffer);
 				renderer.endFrame();
 			}
+			releaseQueue.collect();
 		}
 		vkDeviceWaitIdle(device.device());
 
@@ -627,6 +843,65 @@ namespace assignment
 		ImGui::DestroyContext();
 	}
 
+	bool Application::verifySplineSurface()
+	{
+		const uint32_t rows = 6, cols = 5;
+		std::vector<Model::Vertex> controlPoints(rows * cols);
+		for (uint32_t i = 0; i < rows; i++)
+		{
+			for (uint32_t j = 0; j < cols; j++)
+			{
+				const float x = float(j) / (cols - 1);
+				const float z = float(i) / (rows - 1);
+				controlPoints[i * cols + j].position = { x, 0.3f * std::sin(3.f * x + 5.f * z), z };
+			}
+		}
+
+		struct Case { uint32_t degreeU, degreeV, subdivisions; };
+		const Case cases[] = { { 1, 1, 2 }, { 2, 3, 17 }, { 3, 3, 200 }, { 5, 4, 64 } };
+
+		bool passed = true;
+		DeferredReleaseQueue releaseQueue(device);
+		SplineSurfaceComputeSystem splineSurface(device, releaseQueue, rows, cols, 1, 1, 2);
+		for (const Case& c : cases)
+		{
+			splineSurface.setParameters(c.degreeU, c.degreeV, c.subdivisions);
+			const float difference = splineSurface.compareWithCpu(controlPoints);
+			const bool ok = difference <= 1e-3f;
+			passed = passed && ok;
+			std::cout << std::format("degree {}x{}, {} subdivisions: max difference {} {}\n",
+				c.degreeU, c.degreeV, c.subdivisions, difference, ok ? "ok" : "FAILED");
+
+			// Moving single control points only dispatches their local support, which has to match the
+			// CPU evaluation of the whole net as well: an interior point, then a corner for the clamped ends.
+			std::vector<Model::Vertex> movedControlPoints = controlPoints;
+			for (const uint32_t moved : { 2 * cols + 2, rows * cols - 1 })
+			{
+				movedControlPoints[moved].position.y += 0.25f;
+				const float movedDifference = splineSurface.compareWithCpu(movedControlPoints);
+				const bool movedOk = movedDifference <= 1e-3f;
+				passed = passed && movedOk;
+				std::cout << std::format("  control point {} moved: max difference {} {}\n", moved, movedDifference, movedOk ? "ok" : "FAILED");
+			}
+
+			const std::vector<float> knotsU = SurfaceMesh::calculateKnots(c.degreeU, rows);
+			const std::vector<float> knotsV = SurfaceMesh::calculateKnots(c.degreeV, cols);
+			const std::vector<Model::Vertex> basis = SurfaceEvaluationPlan(c.degreeU, c.degreeV, knotsU, knotsV, c.subdivisions).evaluate(controlPoints);
+			const std::vector<Model::Vertex> bezier = SurfaceMesh::calculateBezierSurface(c.degreeU, c.degreeV, knotsU, knotsV, controlPoints, c.subdivisions);
+			float bezierDifference = 0.f;
+			for (size_t i = 0; i < basis.size(); i++)
+			{
+				const glm::vec3 position = glm::abs(basis[i].position - bezier[i].position);
+				const glm::vec3 normal = glm::abs(basis[i].normal - bezier[i].normal);
+				bezierDifference = std::max({ bezierDifference, position.x, position.y, position.z, normal.x, normal.y, normal.z });
+			}
+			const bool bezierOk = bezierDifference <= 1e-5f;
+			passed = passed && bezierOk;
+			std::cout << std::format("  Bezier patches: max difference {} {}\n", bezierDifference, bezierOk ? "ok" : "FAILED");
+		}
+		return passed;
+	}
+
 	void Application::loadGameObjects()
 	{
 		std::shared_ptr<Model> cube = Model::createModelFromFile(device, "./assets/meshes/cube.obj");
@@ -643,41 +918,17 @@ namespace assignment
 		gameObjects.push_back(std::move(cubeObject));
 
 
-		Line::Vertex v1, v2;
-		v1.position = { -1000.f, 0.f, 0.f };
-		v1.color = { 1.f, 0.f, 0.f };
-		v2.position = { 1000.f, 0.f, 0.f };
-		v2.color = { 1.f, 0.f, 0.f };
-		std::vector<Line::Vertex> axisLine = { v1, v2 };
+		// The three axes are one line strip object, split by restart indices.
+		std::vector<std::vector<Line::Vertex>> axisLines(3, std::vector<Line::Vertex>(2));
+		for (int i = 0; i < 3; i++)
+		{
+			axisLines[i][0].position[i] = -1000.f;
+			axisLines[i][1].position[i] = 1000.f;
+			axisLines[i][0].color[i] = axisLines[i][1].color[i] = 1.f;
+		}
 
 		auto axis = GameObject::createGameObject();
-		axis.line = Line::createLineFromVector(device, axisLine);
-		axis.transform.translation = glm::vec3(0.f);
-		axis.transform.scale = glm::vec3(1.f);
-		axis.transform.rotation = { 0.f, 0.f, 0.f };
-		lineObjects.push_back(std::move(axis));
-
-		v1.position = { 0.f,  -1000.f, 0.f };
-		v1.color = { 0.f, 1.f, 0.f };
-		v2.position = { 0.f,  1000.f, 0.f };
-		v2.color = { 0.f, 1.f, 0.f };
-		axisLine = { v1, v2 };
-
-		axis = GameObject::createGameObject();
-		axis.line = Line::createLineFromVector(device, axisLine);
-		axis.transform.translation = glm::vec3(0.f);
-		axis.transform.scale = glm::vec3(1.f);
-		axis.transform.rotation = { 0.f, 0.f, 0.f };
-		lineObjects.push_back(std::move(axis));
-
-		v1.position = { 0.f, 0.f,  -1000.f };
-		v1.color = { 0.f, 0.f, 1.f };
-		v2.position = { 0.f, 0.f, 1000.f };
-		v2.color = { 0.f, 0.f, 1.f };
-		axisLine = { v1, v2 };
-
-		axis = GameObject::createGameObject();
-		axis.line = Line::createLineFromVector(device, axisLine);
+		axis.line = Line::createLineFromStrips(device, axisLines);
 		axis.transform.translation = glm::vec3(0.f);
 		axis.transform.scale = glm::vec3(1.f);
 		axis.transform.rotation = { 0.f, 0.f, 0.f };
@@ -25,6 +25,8 @@ namespace assignment
 
 	public:
 		void run();
+		// Compares the compute shader spline surface with the CPU evaluation without entering the render loop.
+		bool verifySplineSurface();
 
 	private:
 		void loadGameObjects();
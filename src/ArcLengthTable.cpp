@@ -0,0 +1,110 @@
+#include "ArcLengthTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace assignment
+{
+	namespace
+	{
+		constexpr uint32_t MAX_REFINEMENTS = 4;
+		// Relative to the length of the chord the distance falls into.
+		constexpr float REFINEMENT_TOLERANCE = 1e-4f;
+	}
+
+	ArcLengthTable::ArcLengthTable(Curve curve, const std::vector<float>& breakpoints, uint32_t samplesPerPiece)
+		: curve(std::move(curve))
+	{
+		assert(breakpoints.size() >= 2 && "Curve needs at least one interval");
+		assert(samplesPerPiece >= 1 && "Every interval needs at least one chord");
+
+		params.push_back(breakpoints.front());
+		points.push_back(this->curve(params.back()));
+		lengths.push_back(0.f);
+
+		for (size_t i = 1; i < breakpoints.size(); i++)
+		{
+			const float a = params.back();
+			const float b = breakpoints[i];
+			if (b <= a)
+				continue;
+
+			for (uint32_t j = 1; j <= samplesPerPiece; j++)
+			{
+				const float t = j == samplesPerPiece ? b : a + (b - a) * float(j) / float(samplesPerPiece);
+				const glm::vec3 point = this->curve(t);
+				lengths.push_back(lengths.back() + glm::distance(point, points.back()));
+				params.push_back(t);
+				points.push_back(point);
+			}
+		}
+	}
+
+	float ArcLengthTable::parameterAt(float distance) const
+	{
+		if (params.size() < 2)
+			return params.front();
+
+		distance = std::clamp(distance, 0.f, length());
+
+		// Chord i runs from sample i - 1 to sample i.
+		const size_t i = std::clamp<size_t>(
+			std::upper_bound(lengths.begin(), lengths.end(), distance) - lengths.begin(), 1, lengths.size() - 1);
+		const float chord = lengths[i] - lengths[i - 1];
+		if (chord <= 0.f)
+			return params[i - 1];
+
+		// The point whose chord from sample i - 1 is exactly the remaining distance long: a root of
+		// g(t) = |C(t) - C(t[i - 1])| - target, bracketed by the two samples. Newton steps with the slope
+		// of the bracket (false position, Illinois variant) stay inside it; the first one is the linear
+		// interpolation in the table.
+		const float target = distance - lengths[i - 1];
+		float lo = params[i - 1], hi = params[i];
+		float gLo = -target, gHi = chord - target;
+		int side = 0;
+
+		float t = lo;
+		for (uint32_t k = 0; k <= MAX_REFINEMENTS; k++)
+		{
+			t = gHi > gLo ? lo - gLo * (hi - lo) / (gHi - gLo) : lo;
+			if (k == MAX_REFINEMENTS)
+				break;
+
+			const float g = glm::distance(curve(t), points[i - 1]) - target;
+			if (std::abs(g) <= REFINEMENT_TOLERANCE * chord)
+				break;
+
+			if (g < 0.f)
+			{
+				lo = t;
+				gLo = g;
+				if (side < 0)
+					gHi *= 0.5f;
+				side = -1;
+			}
+			else
+			{
+				hi = t;
+				gHi = g;
+				if (side > 0)
+					gLo *= 0.5f;
+				side = 1;
+			}
+		}
+
+		return t;
+	}
+
+	std::vector<float> ArcLengthTable::evenlySpacedParameters(uint32_t count) const
+	{
+		assert(count >= 2 && "Need at least both ends");
+
+		std::vector<float> result(count);
+		result.front() = params.front();
+		for (uint32_t k = 1; k < count - 1; k++)
+			result[k] = parameterAt(length() * float(k) / float(count - 1));
+		result.back() = params.back();
+		return result;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CurveFlattener.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Cumulative chord lengths of a parametric curve, so the parameter at a given distance along it
+	// is a binary search plus a few refinement steps instead of a walk over the curve. Sampling at
+	// evenly spaced distances gives the same density everywhere, where evenly spaced parameters
+	// bunch up wherever the curve moves slowly.
+	class ArcLengthTable
+	{
+	public:
+		using Curve = CurveFlattener::Curve;
+
+		// breakpoints are the increasing parameters the curve is split at (knots, segment ends);
+		// every interval between them gets samplesPerPiece chords.
+		ArcLengthTable(Curve curve, const std::vector<float>& breakpoints, uint32_t samplesPerPiece = 32);
+
+	public:
+		float length() const { return lengths.back(); }
+
+		// distance is clamped to [0, length()].
+		float parameterAt(float distance) const;
+		glm::vec3 pointAt(float distance) const { return curve(parameterAt(distance)); }
+
+		// count >= 2 parameters a constant distance apart, both ends included.
+		std::vector<float> evenlySpacedParameters(uint32_t count) const;
+
+	private:
+		Curve curve;
+		std::vector<float> params;
+		std::vector<glm::vec3> points;
+		std::vector<float> lengths;
+	};
+}
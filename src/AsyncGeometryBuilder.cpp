@@ -0,0 +1,174 @@
+#include "AsyncGeometryBuilder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace assignment
+{
+	AsyncGeometryBuilder::AsyncGeometryBuilder(Device& device)
+		: device(device)
+	{
+		worker = std::thread(&AsyncGeometryBuilder::work, this);
+	}
+
+	AsyncGeometryBuilder::~AsyncGeometryBuilder()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		condition.notify_one();
+		worker.join();
+
+		for (Upload& upload : uploads)
+		{
+			vkWaitForFences(device.device(), 1, &upload.fence, VK_TRUE, UINT64_MAX);
+			vkDestroyFence(device.device(), upload.fence, nullptr);
+			vkFreeCommandBuffers(device.device(), device.getCommandPool(), 1, &upload.commandBuffer);
+		}
+	}
+
+	void AsyncGeometryBuilder::post(uint32_t slot, Build build, Ready ready)
+	{
+		const uint64_t generation = ++nextGeneration;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [slot](const Job& job) { return job.slot == slot; }), jobs.end());
+			jobs.push_back({ slot, generation, std::move(build), std::move(ready) });
+		}
+		condition.notify_one();
+	}
+
+	void AsyncGeometryBuilder::cancel(uint32_t slot)
+	{
+		oldestCurrent[slot] = ++nextGeneration;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [slot](const Job& job) { return job.slot == slot; }), jobs.end());
+	}
+
+	void AsyncGeometryBuilder::update()
+	{
+		std::vector<Built> finished;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (error)
+				std::rethrow_exception(std::exchange(error, nullptr));
+			finished.swap(built);
+		}
+
+		for (Built& result : finished)
+			if (isCurrent(result.slot, result.generation))
+				submit(result);
+
+		for (auto it = uploads.begin(); it != uploads.end();)
+		{
+			const VkResult status = vkGetFenceStatus(device.device(), it->fence);
+			if (status == VK_NOT_READY)
+			{
+				++it;
+				continue;
+			}
+			if (status != VK_SUCCESS)
+				throw std::runtime_error("Failed to upload geometry");
+
+			vkDestroyFence(device.device(), it->fence, nullptr);
+			vkFreeCommandBuffers(device.device(), device.getCommandPool(), 1, &it->commandBuffer);
+			it->primitive->releaseStagingBuffers();
+
+			if (isCurrent(it->slot, it->generation))
+			{
+				oldestCurrent[it->slot] = it->generation;
+				it->ready(std::move(it->primitive));
+			}
+			it = uploads.erase(it);
+		}
+	}
+
+	bool AsyncGeometryBuilder::isIdle() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return jobs.empty() && built.empty() && !busy && uploads.empty();
+	}
+
+	void AsyncGeometryBuilder::work()
+	{
+		for (;;)
+		{
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+				if (stopping)
+					return;
+
+				job = std::move(jobs.front());
+				jobs.pop_front();
+				busy = true;
+			}
+
+			Built result{ job.slot, job.generation, nullptr, std::move(job.ready) };
+			std::exception_ptr failure;
+			try
+			{
+				result.primitive = job.build();
+			}
+			catch (...)
+			{
+				failure = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			busy = false;
+			if (failure)
+				error = failure;
+			else
+				built.push_back(std::move(result));
+		}
+	}
+
+	void AsyncGeometryBuilder::submit(Built& result)
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = device.getCommandPool();
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer;
+		if (vkAllocateCommandBuffers(device.device(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("Failed to allocate geometry upload command buffer");
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+		result.primitive->recordUpload(commandBuffer);
+		vkEndCommandBuffer(commandBuffer);
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		VkFence fence;
+		if (vkCreateFence(device.device(), &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create geometry upload fence");
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, fence) != VK_SUCCESS)
+			throw std::runtime_error("Failed to submit geometry upload");
+
+		uploads.push_back({ result.slot, result.generation, std::move(result.primitive), std::move(result.ready), commandBuffer, fence });
+	}
+
+	bool AsyncGeometryBuilder::isCurrent(uint32_t slot, uint64_t generation) const
+	{
+		const auto it = oldestCurrent.find(slot);
+		return it == oldestCurrent.end() || generation >= it->second;
+	}
+}
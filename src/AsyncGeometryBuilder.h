@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Device.h"
+#include "GraphicsPrimitive.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace assignment
+{
+	// Builds primitives on a worker thread and uploads them without waiting on the queue.
+	// The worker runs the tessellation and fills the staging buffers of a deferred primitive;
+	// update() on the render thread submits the copy with a fence and, once the fence has
+	// signaled in a later frame, hands the primitive to the ready callback.
+	class AsyncGeometryBuilder
+	{
+	public:
+		// Runs on the worker; must return a primitive created with DeferredUpload.
+		using Build = std::function<std::unique_ptr<GraphicsPrimitive>()>;
+		// Runs on the render thread inside update().
+		using Ready = std::function<void(std::shared_ptr<GraphicsPrimitive>)>;
+
+		explicit AsyncGeometryBuilder(Device& device);
+		~AsyncGeometryBuilder();
+
+		NO_COPY(AsyncGeometryBuilder);
+
+	public:
+		// A request for a slot replaces the one still queued for it. Results older than the
+		// last one delivered for the slot are dropped, so a slot never goes back in time.
+		void post(uint32_t slot, Build build, Ready ready);
+		// Drops the queued request for the slot and everything still on its way.
+		void cancel(uint32_t slot);
+		// Call once per frame: submits what the worker finished and delivers the completed uploads.
+		// Rethrows an exception thrown by a build.
+		void update();
+
+		bool isIdle() const;
+
+	private:
+		struct Job
+		{
+			uint32_t slot;
+			uint64_t generation;
+			Build build;
+			Ready ready;
+		};
+
+		struct Built
+		{
+			uint32_t slot;
+			uint64_t generation;
+			std::unique_ptr<GraphicsPrimitive> primitive;
+			Ready ready;
+		};
+
+		struct Upload
+		{
+			uint32_t slot;
+			uint64_t generation;
+			std::shared_ptr<GraphicsPrimitive> primitive;
+			Ready ready;
+			VkCommandBuffer commandBuffer;
+			VkFence fence;
+		};
+
+		void work();
+		void submit(Built& built);
+		bool isCurrent(uint32_t slot, uint64_t generation) const;
+
+	private:
+		Device& device;
+
+		// Shared with the worker.
+		mutable std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<Job> jobs;
+		std::vector<Built> built;
+		std::exception_ptr error;
+		bool busy = false;
+		bool stopping = false;
+
+		// Render thread only.
+		uint64_t nextGeneration = 0;
+		std::unordered_map<uint32_t, uint64_t> oldestCurrent;
+		std::vector<Upload> uploads;
+
+		std::thread worker;
+	};
+}
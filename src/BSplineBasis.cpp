@@ -0,0 +1,78 @@
+#include "BSplineBasis.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace assignment
+{
+	uint32_t BSplineBasis::findSpan(uint32_t degree, float u, const std::vector<float>& knots, uint32_t controlPointCount)
+	{
+		assert(controlPointCount > degree && "Not enough control points for the degree");
+		assert(knots.size() >= controlPointCount + degree + 1 && "Not enough knots");
+
+		const uint32_t last = controlPointCount - 1;
+		if (u >= knots[last + 1])
+			return last;
+		if (u <= knots[degree])
+			return degree;
+
+		auto first = knots.begin() + degree + 1;
+		auto end = knots.begin() + last + 1;
+		return uint32_t(std::upper_bound(first, end, u) - knots.begin()) - 1;
+	}
+
+	void BSplineBasis::evaluate(uint32_t span, float u, uint32_t degree, const std::vector<float>& knots, float* basis)
+	{
+		assert(degree <= MAX_DEGREE && "B-spline degree is too high");
+
+		float left[MAX_DEGREE + 1];
+		float right[MAX_DEGREE + 1];
+
+		basis[0] = 1.f;
+		for (uint32_t j = 1; j <= degree; j++)
+		{
+			left[j] = u - knots[span + 1 - j];
+			right[j] = knots[span + j] - u;
+
+			float saved = 0.f;
+			for (uint32_t r = 0; r < j; r++)
+			{
+				const float denominator = right[r + 1] + left[j - r];
+				const float temp = denominator == 0.f ? 0.f : basis[r] / denominator;
+				basis[r] = saved + right[r + 1] * temp;
+				saved = left[j - r] * temp;
+			}
+			basis[j] = saved;
+		}
+	}
+
+	void BSplineBasis::evaluate(uint32_t span, float u, uint32_t degree, const std::vector<float>& knots, float* basis, float* derivatives)
+	{
+		if (degree == 0)
+		{
+			basis[0] = 1.f;
+			derivatives[0] = 0.f;
+			return;
+		}
+
+		// The last step of the recurrence divides every degree - 1 function by the same knot
+		// difference as the derivative formula (eq. 2.7), so both come out of one loop.
+		evaluate(span, u, degree - 1, knots, basis);
+
+		float saved = 0.f;
+		float savedDerivative = 0.f;
+		for (uint32_t r = 0; r < degree; r++)
+		{
+			const float left = u - knots[span + 1 + r - degree];
+			const float right = knots[span + 1 + r] - u;
+			const float denominator = right + left;
+			const float temp = denominator == 0.f ? 0.f : basis[r] / denominator;
+			basis[r] = saved + right * temp;
+			saved = left * temp;
+			derivatives[r] = savedDerivative - degree * temp;
+			savedDerivative = degree * temp;
+		}
+		basis[degree] = saved;
+		derivatives[degree] = savedDerivative;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Non-recursive B-spline basis evaluation (The NURBS Book, A2.1 / A2.2 / A2.3).
+	// Only the degree + 1 functions that are non-zero on a knot span are computed.
+	class BSplineBasis
+	{
+	public:
+		static constexpr uint32_t MAX_DEGREE = 32;
+
+	public:
+		// Index of the knot span [knots[span], knots[span + 1]) containing u.
+		// u outside of [knots[degree], knots[controlPointCount]] is clamped to the first/last span.
+		static uint32_t findSpan(uint32_t degree, float u, const std::vector<float>& knots, uint32_t controlPointCount);
+
+		// Writes N[span - degree + k](u) into basis[k] for k in [0, degree].
+		static void evaluate(uint32_t span, float u, uint32_t degree, const std::vector<float>& knots, float* basis);
+		// Same as above, and writes the first derivatives dN/du into derivatives[k] (A2.3 for n = 1).
+		static void evaluate(uint32_t span, float u, uint32_t degree, const std::vector<float>& knots, float* basis, float* derivatives);
+	};
+}
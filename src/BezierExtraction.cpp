@@ -0,0 +1,265 @@
+#include "BezierExtraction.h"
+
+#include <algorithm>
+#include <cassert>
+#include <execution>
+#include <numeric>
+
+namespace assignment
+{
+	uint32_t BezierExtraction::Curve::findSegment(float u) const
+	{
+		return findPiece(breakpoints, u);
+	}
+
+	glm::vec3 BezierExtraction::Curve::evaluate(float u) const
+	{
+		const uint32_t s = findSegment(u);
+		const float a = breakpoints[s];
+		const float b = breakpoints[s + 1];
+		return deCasteljau(&points[size_t(s) * (degree + 1)], degree, (u - a) / (b - a));
+	}
+
+	const glm::vec3* BezierExtraction::Surface::patch(uint32_t a, uint32_t b) const
+	{
+		return &points[(size_t(a) * patchCountV() + b) * (degreeU + 1) * (degreeV + 1)];
+	}
+
+	glm::vec3 BezierExtraction::Surface::evaluate(float u, float v) const
+	{
+		const uint32_t a = findPiece(breakpointsU, u);
+		const uint32_t b = findPiece(breakpointsV, v);
+		const float s = (u - breakpointsU[a]) / (breakpointsU[a + 1] - breakpointsU[a]);
+		const float t = (v - breakpointsV[b]) / (breakpointsV[b + 1] - breakpointsV[b]);
+
+		// Collapse the rows in V first, then the resulting column in U.
+		const glm::vec3* block = patch(a, b);
+		glm::vec3 column[MAX_DEGREE + 1];
+		for (uint32_t r = 0; r <= degreeU; r++)
+			column[r] = deCasteljau(block + size_t(r) * (degreeV + 1), degreeV, t);
+		return deCasteljau(column, degreeU, s);
+	}
+
+	std::vector<Vertex> BezierExtraction::Surface::evaluateGrid(uint32_t subdivisions, const glm::vec3& color, bool parallel) const
+	{
+		assert(subdivisions >= 2 && "Spline surface needs at least 2 subdivisions");
+
+		std::vector<Vertex> result(size_t(subdivisions) * subdivisions);
+
+		// Patch column and local parameter of every grid column are shared by all rows.
+		std::vector<uint32_t> columnPatch(subdivisions);
+		std::vector<float> columnT(subdivisions);
+		for (uint32_t j = 0; j < subdivisions; j++)
+		{
+			const float v = breakpointsV.front() + (breakpointsV.back() - breakpointsV.front()) * float(j) / float(subdivisions - 1);
+			const uint32_t b = findPiece(breakpointsV, v);
+			columnPatch[j] = b;
+			columnT[j] = (v - breakpointsV[b]) / (breakpointsV[b + 1] - breakpointsV[b]);
+		}
+
+		auto evaluateRow = [&](uint32_t i)
+		{
+			const float u = breakpointsU.front() + (breakpointsU.back() - breakpointsU.front()) * float(i) / float(subdivisions - 1);
+			const uint32_t a = findPiece(breakpointsU, u);
+			const float s = (u - breakpointsU[a]) / (breakpointsU[a + 1] - breakpointsU[a]);
+
+			Vertex* row = result.data() + size_t(i) * subdivisions;
+			glm::vec3 column[MAX_DEGREE + 1];
+			glm::vec3 columnDerivative[MAX_DEGREE + 1];
+			for (uint32_t j = 0; j < subdivisions; j++)
+			{
+				const glm::vec3* block = patch(a, columnPatch[j]);
+				for (uint32_t r = 0; r <= degreeU; r++)
+					column[r] = deCasteljau(block + size_t(r) * (degreeV + 1), degreeV, columnT[j], columnDerivative[r]);
+
+				// Derivatives with respect to the local parameters; the positive interval
+				// scale does not change the direction of the normal.
+				glm::vec3 S_u;
+				row[j].position = deCasteljau(column, degreeU, s, S_u);
+				const glm::vec3 S_v = deCasteljau(columnDerivative, degreeU, s);
+
+				const glm::vec3 normal = glm::cross(S_v, S_u);
+				const float length = glm::length(normal);
+				row[j].normal = length > 0.f ? normal / length : glm::vec3(0.f);
+				row[j].color = color;
+			}
+		};
+
+		if (!parallel)
+		{
+			for (uint32_t i = 0; i < subdivisions; i++)
+				evaluateRow(i);
+			return result;
+		}
+
+		std::vector<uint32_t> rows(subdivisions);
+		std::iota(rows.begin(), rows.end(), 0u);
+		std::for_each(std::execution::par, rows.begin(), rows.end(), evaluateRow);
+		return result;
+	}
+
+	BezierExtraction::Curve BezierExtraction::extractCurve(uint32_t degree, const std::vector<float>& knots, const std::vector<glm::vec3>& controlPoints)
+	{
+		assert(degree <= MAX_DEGREE && "Bezier extraction degree is too high");
+		assert(knots.size() == controlPoints.size() + degree + 1 && "Knot vector does not match the control points");
+
+		const uint32_t count = uint32_t(controlPoints.size());
+		const std::vector<uint32_t> spans = domainSpans(degree, knots, count);
+
+		Curve curve;
+		curve.degree = degree;
+		curve.points.resize(spans.size() * (degree + 1));
+		curve.breakpoints.reserve(spans.size() + 1);
+		for (size_t s = 0; s < spans.size(); s++)
+		{
+			curve.breakpoints.push_back(knots[spans[s]]);
+			extractSpan(degree, knots, spans[s], controlPoints.data(), 1, &curve.points[s * (degree + 1)], 1);
+		}
+		curve.breakpoints.push_back(knots[count]);
+
+		return curve;
+	}
+
+	BezierExtraction::Surface BezierExtraction::extractSurface(
+		uint32_t degreeU,
+		uint32_t degreeV,
+		const std::vector<float>& knotsU,
+		const std::vector<float>& knotsV,
+		const std::vector<Vertex>& controlPoints)
+	{
+		assert(degreeU <= MAX_DEGREE && degreeV <= MAX_DEGREE && "Bezier extraction degree is too high");
+
+		const uint32_t m = uint32_t(knotsU.size()) - degreeU - 1;
+		const uint32_t n = uint32_t(knotsV.size()) - degreeV - 1;
+		assert(controlPoints.size() >= size_t(m) * n && "Not enough control points");
+
+		std::vector<glm::vec3> net(size_t(m) * n);
+		for (size_t i = 0; i < net.size(); i++)
+			net[i] = controlPoints[i].position;
+
+		const std::vector<uint32_t> spansU = domainSpans(degreeU, knotsU, m);
+		const std::vector<uint32_t> spansV = domainSpans(degreeV, knotsV, n);
+		const uint32_t orderU = degreeU + 1;
+		const uint32_t orderV = degreeV + 1;
+
+		Surface surface;
+		surface.degreeU = degreeU;
+		surface.degreeV = degreeV;
+		for (uint32_t span : spansU)
+			surface.breakpointsU.push_back(knotsU[span]);
+		surface.breakpointsU.push_back(knotsU[m]);
+		for (uint32_t span : spansV)
+			surface.breakpointsV.push_back(knotsV[span]);
+		surface.breakpointsV.push_back(knotsV[n]);
+
+		// Split every control column in U: spansU * orderU rows of n points.
+		std::vector<glm::vec3> rows(spansU.size() * orderU * n);
+		for (uint32_t j = 0; j < n; j++)
+			for (size_t a = 0; a < spansU.size(); a++)
+				extractSpan(degreeU, knotsU, spansU[a], net.data() + j, n, &rows[a * orderU * n + j], n);
+
+		// Then every one of those rows in V, straight into the patch blocks.
+		const size_t patchCountV = spansV.size();
+		surface.points.resize(spansU.size() * orderU * patchCountV * orderV);
+		for (size_t row = 0; row < spansU.size() * orderU; row++)
+		{
+			const size_t a = row / orderU;
+			const size_t r = row % orderU;
+			for (size_t b = 0; b < patchCountV; b++)
+			{
+				glm::vec3* block = &surface.points[((a * patchCountV + b) * orderU + r) * orderV];
+				extractSpan(degreeV, knotsV, spansV[b], &rows[row * n], 1, block, 1);
+			}
+		}
+
+		return surface;
+	}
+
+	glm::vec3 BezierExtraction::deCasteljau(const glm::vec3* points, uint32_t degree, float t)
+	{
+		glm::vec3 b[MAX_DEGREE + 1];
+		std::copy(points, points + degree + 1, b);
+
+		for (uint32_t r = 1; r <= degree; r++)
+			for (uint32_t k = 0; k <= degree - r; k++)
+				b[k] = b[k] + t * (b[k + 1] - b[k]);
+
+		return b[0];
+	}
+
+	glm::vec3 BezierExtraction::deCasteljau(const glm::vec3* points, uint32_t degree, float t, glm::vec3& derivative)
+	{
+		if (degree == 0)
+		{
+			derivative = glm::vec3(0.f);
+			return points[0];
+		}
+
+		glm::vec3 b[MAX_DEGREE + 1];
+		std::copy(points, points + degree + 1, b);
+
+		for (uint32_t r = 1; r < degree; r++)
+			for (uint32_t k = 0; k <= degree - r; k++)
+				b[k] = b[k] + t * (b[k + 1] - b[k]);
+
+		derivative = float(degree) * (b[1] - b[0]);
+		return b[0] + t * (b[1] - b[0]);
+	}
+
+	std::vector<uint32_t> BezierExtraction::domainSpans(uint32_t degree, const std::vector<float>& knots, uint32_t count)
+	{
+		assert(count > degree && "Not enough control points for the degree");
+
+		std::vector<uint32_t> spans;
+		for (uint32_t span = degree; span < count; span++)
+			if (knots[span] < knots[span + 1])
+				spans.push_back(span);
+
+		assert(!spans.empty() && "Knot vector has an empty domain");
+		return spans;
+	}
+
+	void BezierExtraction::extractSpan(
+		uint32_t degree,
+		const std::vector<float>& knots,
+		uint32_t span,
+		const glm::vec3* points,
+		size_t stride,
+		glm::vec3* result,
+		size_t resultStride)
+	{
+		const float a = knots[span];
+		const float b = knots[span + 1];
+		const uint32_t first = span - degree;
+
+		// Bezier point k is what is left of the span's control points after inserting a
+		// (degree - k) times and b k times. Every insertion is one level of the Boehm/de Boor
+		// triangle; only the last point of the triangle is needed, so it is run per k.
+		glm::vec3 d[MAX_DEGREE + 1];
+		for (uint32_t k = 0; k <= degree; k++)
+		{
+			for (uint32_t l = 0; l <= degree; l++)
+				d[l] = points[(first + l) * stride];
+
+			for (uint32_t r = 1; r <= degree; r++)
+			{
+				const float u = r <= degree - k ? a : b;
+				for (uint32_t l = degree; l >= r; l--)
+				{
+					const float left = knots[first + l];
+					const float right = knots[span + l + 1 - r];
+					const float alpha = (u - left) / (right - left);
+					d[l] = (1.f - alpha) * d[l - 1] + alpha * d[l];
+				}
+			}
+
+			result[k * resultStride] = d[degree];
+		}
+	}
+
+	uint32_t BezierExtraction::findPiece(const std::vector<float>& breakpoints, float u)
+	{
+		const auto it = std::upper_bound(breakpoints.begin() + 1, breakpoints.end() - 1, u);
+		return uint32_t(it - breakpoints.begin()) - 1;
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "BSplineBasis.h"
+#include "Vertex.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Splits B-spline curves and tensor product surfaces into their Bezier pieces by inserting
+	// every knot of a span until it has multiplicity degree (Boehm). A piece only needs its own
+	// degree + 1 (or (degreeU + 1) x (degreeV + 1)) control points, so evaluating a sample costs
+	// the same no matter how long the knot vector is, and every piece can be handled on its own.
+	class BezierExtraction
+	{
+	public:
+		// Size of the fixed coefficient blocks used by de Casteljau.
+		static constexpr uint32_t MAX_DEGREE = BSplineBasis::MAX_DEGREE;
+
+		struct Curve
+		{
+			uint32_t degree = 0;
+			// Distinct knots of the domain, segment s spans [breakpoints[s], breakpoints[s + 1]].
+			std::vector<float> breakpoints{};
+			// degree + 1 Bezier points per segment.
+			std::vector<glm::vec3> points{};
+
+			uint32_t segmentCount() const { return uint32_t(breakpoints.size()) - 1; }
+			// u outside of the domain is clamped to the first/last segment.
+			uint32_t findSegment(float u) const;
+			glm::vec3 evaluate(float u) const;
+		};
+
+		struct Surface
+		{
+			uint32_t degreeU = 0;
+			uint32_t degreeV = 0;
+			std::vector<float> breakpointsU{};
+			std::vector<float> breakpointsV{};
+			// Patch (a, b) owns the (degreeU + 1) x (degreeV + 1) row-major block
+			// starting at (a * patchCountV() + b) * (degreeU + 1) * (degreeV + 1).
+			std::vector<glm::vec3> points{};
+
+			uint32_t patchCountU() const { return uint32_t(breakpointsU.size()) - 1; }
+			uint32_t patchCountV() const { return uint32_t(breakpointsV.size()) - 1; }
+			const glm::vec3* patch(uint32_t a, uint32_t b) const;
+			glm::vec3 evaluate(float u, float v) const;
+
+			// Same sample grid, layout and normals as SurfaceEvaluationPlan::evaluate; parallel splits the rows across cores.
+			std::vector<Vertex> evaluateGrid(uint32_t subdivisions, const glm::vec3& color, bool parallel = false) const;
+		};
+
+	public:
+		// knots must hold controlPoints.size() + degree + 1 values.
+		static Curve extractCurve(uint32_t degree, const std::vector<float>& knots, const std::vector<glm::vec3>& controlPoints);
+		// controlPoints is the row-major net, index = i * countV + j with countV = knotsV.size() - degreeV - 1.
+		static Surface extractSurface(
+			uint32_t degreeU,
+			uint32_t degreeV,
+			const std::vector<float>& knotsU,
+			const std::vector<float>& knotsV,
+			const std::vector<Vertex>& controlPoints);
+
+		static glm::vec3 deCasteljau(const glm::vec3* points, uint32_t degree, float t);
+		// Also writes the derivative with respect to t, taken from the last but one level.
+		static glm::vec3 deCasteljau(const glm::vec3* points, uint32_t degree, float t, glm::vec3& derivative);
+
+	private:
+		// Knot spans of the domain [knots[degree], knots[count]] with a non-zero length.
+		static std::vector<uint32_t> domainSpans(uint32_t degree, const std::vector<float>& knots, uint32_t count);
+		// Bezier points of span [knots[span], knots[span + 1]] from the degree + 1 control points starting at
+		// points[(span - degree) * stride]; the result goes to result[k * resultStride].
+		static void extractSpan(
+			uint32_t degree,
+			const std::vector<float>& knots,
+			uint32_t span,
+			const glm::vec3* points,
+			size_t stride,
+			glm::vec3* result,
+			size_t resultStride);
+		static uint32_t findPiece(const std::vector<float>& breakpoints, float u);
+	};
+}
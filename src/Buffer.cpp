@@ -27,22 +27,21 @@ namespace assignment
 	{
 		unmap();
 		vkDestroyBuffer(device.device(), buffer, nullptr);
-		vkFreeMemory(device.device(), memory, nullptr);
+		device.freeMemory(memory);
 	}
 
+	// Host visible memory stays mapped by the allocator, so mapping only hands out the address.
 	VkResult Buffer::map(VkDeviceSize size, VkDeviceSize offset)
 	{
-		assert(buffer && memory && "Called map on buffer before create");
-		return vkMapMemory(device.device(), memory, offset, size, 0, &mapped);
+		assert(buffer && memory.memory && "Called map on buffer before create");
+		assert(memory.mapped && "Buffer memory is not host visible");
+		mapped = static_cast<char*>(memory.mapped) + offset;
+		return VK_SUCCESS;
 	}
 
 	void Buffer::unmap()
 	{
-		if (mapped)
-		{
-			vkUnmapMemory(device.device(), memory);
-			mapped = nullptr;
-		}
+		mapped = nullptr;
 	}
 
 	void Buffer::writeToBuffer(void* data, VkDeviceSize size, VkDeviceSize offset)
@@ -61,12 +60,7 @@ namespace assignment
 
 	VkResult Buffer::flush(VkDeviceSize size, VkDeviceSize offset)
 	{
-		VkMappedMemoryRange mappedRange{};
-		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		mappedRange.size = size;
-		mappedRange.memory = memory;
-		mappedRange.size = size;
-		mappedRange.offset = offset;
+		VkMappedMemoryRange mappedRange = memoryRange(size, offset);
 		return vkFlushMappedMemoryRanges(device.device(), 1, &mappedRange);
 	}
 
@@ -81,11 +75,7 @@ namespace assignment
 
 	VkResult Buffer::invalidate(VkDeviceSize size, VkDeviceSize offset)
 	{
-		VkMappedMemoryRange mappedRange{};
-		mappedRange.size = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		mappedRange.memory = memory;
-		mappedRange.size = size;
-		mappedRange.offset = offset;
+		VkMappedMemoryRange mappedRange = memoryRange(size, offset);
 		return vkInvalidateMappedMemoryRanges(device.device(), 1, &mappedRange);
 	}
 
@@ -109,6 +99,17 @@ namespace assignment
 		return invalidate(alignmentSize, index * alignmentSize);
 	}
 
+	// The memory may be shared, so VK_WHOLE_SIZE is limited to the buffer's own allocation.
+	VkMappedMemoryRange Buffer::memoryRange(VkDeviceSize size, VkDeviceSize offset) const
+	{
+		VkMappedMemoryRange mappedRange{};
+		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		mappedRange.memory = memory.memory;
+		mappedRange.offset = memory.offset + offset;
+		mappedRange.size = size == VK_WHOLE_SIZE ? memory.size - offset : size;
+		return mappedRange;
+	}
+
 	VkDeviceSize Buffer::getAlignment(VkDeviceSize instanceSize, VkDeviceSize minOffsetAlignment)
 	{
 		if (minOffsetAlignment > 0)
@@ -42,13 +42,14 @@ namespace assignment
 		VkMemoryPropertyFlags getMemoryPropertyFlags() const { return memoryPropertyFlags; }
 
 	private:
+		VkMappedMemoryRange memoryRange(VkDeviceSize size, VkDeviceSize offset) const;
 		static VkDeviceSize getAlignment(VkDeviceSize instanceSize, VkDeviceSize minOffsetAlignment);
 
 	private:
 		Device& device;
 		void* mapped = nullptr;
 		VkBuffer buffer = VK_NULL_HANDLE;
-		VkDeviceMemory memory = VK_NULL_HANDLE;
+		MemoryAllocator::Allocation memory{};
 
 		VkDeviceSize bufferSize;
 		uint32_t instanceCount;
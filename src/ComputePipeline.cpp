@@ -0,0 +1,62 @@
+#include "ComputePipeline.h"
+
+#include "Pipeline.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace assignment
+{
+	ComputePipeline::ComputePipeline(
+		Device& device,
+		const std::string& compFilepath,
+		VkPipelineLayout pipelineLayout)
+		: m_device(device)
+	{
+		createComputePipeline(compFilepath, pipelineLayout);
+	}
+
+	ComputePipeline::~ComputePipeline()
+	{
+		vkDestroyShaderModule(m_device.device(), compShaderModule, nullptr);
+		vkDestroyPipeline(m_device.device(), computePipeline, nullptr);
+	}
+
+	void ComputePipeline::createComputePipeline(const std::string& compFilepath, VkPipelineLayout pipelineLayout)
+	{
+		assert(
+			pipelineLayout != VK_NULL_HANDLE &&
+			"Cannot create compute pipeline: no pipelineLayout provided");
+
+		auto compCode = Pipeline::readFile(compFilepath);
+
+		VkShaderModuleCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = compCode.size();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(compCode.data());
+
+		if (vkCreateShaderModule(m_device.device(), &createInfo, nullptr, &compShaderModule) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create shader module");
+
+		VkPipelineShaderStageCreateInfo shaderStage{};
+		shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		shaderStage.module = compShaderModule;
+		shaderStage.pName = "main";
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage = shaderStage;
+		pipelineInfo.layout = pipelineLayout;
+		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+		pipelineInfo.basePipelineIndex = -1;
+
+		if (vkCreateComputePipelines(m_device.device(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &computePipeline) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create compute pipeline!");
+	}
+
+	void ComputePipeline::bind(VkCommandBuffer commandBuffer)
+	{
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+	}
+}
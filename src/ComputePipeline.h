@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Device.h"
+
+#include <string>
+
+namespace assignment
+{
+	class ComputePipeline
+	{
+	public:
+		NO_COPY(ComputePipeline);
+
+		ComputePipeline(
+			Device& device,
+			const std::string& compFilepath,
+			VkPipelineLayout pipelineLayout);
+		~ComputePipeline();
+
+	public:
+		void bind(VkCommandBuffer commandBuffer);
+
+		VkPipeline getPipeline() const { return computePipeline; }
+
+	private:
+		void createComputePipeline(const std::string& compFilepath, VkPipelineLayout pipelineLayout);
+
+	private:
+		Device& m_device;
+		VkPipeline computePipeline;
+		VkShaderModule compShaderModule;
+	};
+}
@@ -0,0 +1,175 @@
+#include "CurveBatchEvaluator.h"
+
+#include "BSplineBasis.h"
+
+#include <cassert>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CURVE_BATCH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CURVE_BATCH_AVX2_TARGET
+#else
+#include <cpuid.h>
+#define CURVE_BATCH_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace assignment
+{
+	void CurveBatchEvaluator::evaluate(
+		const ControlPolygon& controlPolygon,
+		uint32_t degree,
+		const std::vector<float>& knots,
+		const std::vector<float>& params,
+		Points& result)
+	{
+		assert(controlPolygon.size() > degree && "Not enough control points for the degree");
+		assert(degree <= BSplineBasis::MAX_DEGREE && "B-spline degree is too high");
+
+		const uint32_t count = uint32_t(params.size());
+		result.x.resize(count);
+		result.y.resize(count);
+		result.z.resize(count);
+
+		static const bool useAvx2 = hasAvx2();
+		if (useAvx2)
+			evaluateAvx2(controlPolygon, degree, knots, params.data(), count, result.x.data(), result.y.data(), result.z.data());
+		else
+			evaluateScalar(controlPolygon, degree, knots, params.data(), count, result.x.data(), result.y.data(), result.z.data());
+	}
+
+	void CurveBatchEvaluator::evaluateScalar(
+		const ControlPolygon& controlPolygon,
+		uint32_t degree,
+		const std::vector<float>& knots,
+		const float* params,
+		uint32_t count,
+		float* x, float* y, float* z)
+	{
+		float N[BSplineBasis::MAX_DEGREE + 1];
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const float t = params[i];
+			const uint32_t span = BSplineBasis::findSpan(degree, t, knots, controlPolygon.size());
+			BSplineBasis::evaluate(span, t, degree, knots, N);
+
+			const uint32_t first = span - degree;
+			float px = 0.f, py = 0.f, pz = 0.f;
+			for (uint32_t r = 0; r <= degree; r++)
+			{
+				px += N[r] * controlPolygon.x[first + r];
+				py += N[r] * controlPolygon.y[first + r];
+				pz += N[r] * controlPolygon.z[first + r];
+			}
+			x[i] = px;
+			y[i] = py;
+			z[i] = pz;
+		}
+	}
+
+#ifdef CURVE_BATCH_X86
+	bool CurveBatchEvaluator::hasAvx2()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+	CURVE_BATCH_AVX2_TARGET
+	void CurveBatchEvaluator::evaluateAvx2(
+		const ControlPolygon& controlPolygon,
+		uint32_t degree,
+		const std::vector<float>& knots,
+		const float* params,
+		uint32_t count,
+		float* x, float* y, float* z)
+	{
+		const uint32_t controlPointCount = controlPolygon.size();
+		const float* knotData = knots.data();
+
+		__m256 left[BSplineBasis::MAX_DEGREE + 1];
+		__m256 right[BSplineBasis::MAX_DEGREE + 1];
+		__m256 N[BSplineBasis::MAX_DEGREE + 1];
+		alignas(32) int spans[8];
+
+		const __m256 zero = _mm256_setzero_ps();
+		const uint32_t batchEnd = count - count % 8;
+		for (uint32_t i = 0; i < batchEnd; i += 8)
+		{
+			const __m256 t = _mm256_loadu_ps(params + i);
+			for (uint32_t lane = 0; lane < 8; lane++)
+				spans[lane] = int(BSplineBasis::findSpan(degree, params[i + lane], knots, controlPointCount));
+			const __m256i span = _mm256_load_si256(reinterpret_cast<const __m256i*>(spans));
+
+			// Same triangular scheme as BSplineBasis::evaluate, one knot span per lane.
+			N[0] = _mm256_set1_ps(1.f);
+			for (uint32_t j = 1; j <= degree; j++)
+			{
+				const __m256i leftIndex = _mm256_sub_epi32(span, _mm256_set1_epi32(int(j) - 1));
+				const __m256i rightIndex = _mm256_add_epi32(span, _mm256_set1_epi32(int(j)));
+				left[j] = _mm256_sub_ps(t, _mm256_i32gather_ps(knotData, leftIndex, 4));
+				right[j] = _mm256_sub_ps(_mm256_i32gather_ps(knotData, rightIndex, 4), t);
+
+				__m256 saved = zero;
+				for (uint32_t r = 0; r < j; r++)
+				{
+					const __m256 denominator = _mm256_add_ps(right[r + 1], left[j - r]);
+					const __m256 nonZero = _mm256_cmp_ps(denominator, zero, _CMP_NEQ_OQ);
+					const __m256 temp = _mm256_and_ps(_mm256_div_ps(N[r], denominator), nonZero);
+					N[r] = _mm256_add_ps(saved, _mm256_mul_ps(right[r + 1], temp));
+					saved = _mm256_mul_ps(left[j - r], temp);
+				}
+				N[j] = saved;
+			}
+
+			__m256 px = zero, py = zero, pz = zero;
+			const __m256i first = _mm256_sub_epi32(span, _mm256_set1_epi32(int(degree)));
+			for (uint32_t r = 0; r <= degree; r++)
+			{
+				const __m256i index = _mm256_add_epi32(first, _mm256_set1_epi32(int(r)));
+				px = _mm256_add_ps(px, _mm256_mul_ps(N[r], _mm256_i32gather_ps(controlPolygon.x.data(), index, 4)));
+				py = _mm256_add_ps(py, _mm256_mul_ps(N[r], _mm256_i32gather_ps(controlPolygon.y.data(), index, 4)));
+				pz = _mm256_add_ps(pz, _mm256_mul_ps(N[r], _mm256_i32gather_ps(controlPolygon.z.data(), index, 4)));
+			}
+
+			_mm256_storeu_ps(x + i, px);
+			_mm256_storeu_ps(y + i, py);
+			_mm256_storeu_ps(z + i, pz);
+		}
+
+		evaluateScalar(controlPolygon, degree, knots, params + batchEnd, count - batchEnd, x + batchEnd, y + batchEnd, z + batchEnd);
+	}
+#else
+	bool CurveBatchEvaluator::hasAvx2()
+	{
+		return false;
+	}
+
+	void CurveBatchEvaluator::evaluateAvx2(
+		const ControlPolygon& controlPolygon,
+		uint32_t degree,
+		const std::vector<float>& knots,
+		const float* params,
+		uint32_t count,
+		float* x, float* y, float* z)
+	{
+		evaluateScalar(controlPolygon, degree, knots, params, count, x, y, z);
+	}
+#endif
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Evaluates a B-spline curve at many parameter values at once.
+	// The control polygon is passed as separate x/y/z arrays; on CPUs with AVX2
+	// eight parameters are evaluated per iteration, otherwise a scalar loop is used.
+	class CurveBatchEvaluator
+	{
+	public:
+		struct ControlPolygon
+		{
+			std::vector<float> x{};
+			std::vector<float> y{};
+			std::vector<float> z{};
+
+			uint32_t size() const { return uint32_t(x.size()); }
+		};
+
+		struct Points
+		{
+			std::vector<float> x{};
+			std::vector<float> y{};
+			std::vector<float> z{};
+		};
+
+	public:
+		static void evaluate(
+			const ControlPolygon& controlPolygon,
+			uint32_t degree,
+			const std::vector<float>& knots,
+			const std::vector<float>& params,
+			Points& result);
+
+		static void evaluateScalar(
+			const ControlPolygon& controlPolygon,
+			uint32_t degree,
+			const std::vector<float>& knots,
+			const float* params,
+			uint32_t count,
+			float* x, float* y, float* z);
+
+		static bool hasAvx2();
+
+	private:
+		static void evaluateAvx2(
+			const ControlPolygon& controlPolygon,
+			uint32_t degree,
+			const std::vector<float>& knots,
+			const float* params,
+			uint32_t count,
+			float* x, float* y, float* z);
+	};
+}
@@ -0,0 +1,91 @@
+#include "CurveFlattener.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace assignment
+{
+	void CurveFlattener::flatten(
+		const Curve& curve,
+		const std::vector<float>& breakpoints,
+		const Tolerance& tolerance,
+		std::vector<float>& params,
+		std::vector<glm::vec3>& points)
+	{
+		assert(breakpoints.size() >= 2 && "Curve needs at least one interval");
+		assert(tolerance.minDepth <= tolerance.maxDepth && "Minimum depth exceeds maximum depth");
+
+		params.clear();
+		points.clear();
+
+		float a = breakpoints[0];
+		glm::vec3 pa = curve(a);
+		params.push_back(a);
+		points.push_back(pa);
+
+		for (size_t i = 1; i < breakpoints.size(); i++)
+		{
+			const float b = breakpoints[i];
+			if (b <= a)
+				continue;
+
+			const glm::vec3 pb = curve(b);
+			subdivide(curve, a, b, pa, pb, 0, tolerance, params, points);
+			a = b;
+			pa = pb;
+		}
+	}
+
+	void CurveFlattener::subdivide(
+		const Curve& curve,
+		float a, float b,
+		const glm::vec3& pa, const glm::vec3& pb,
+		uint32_t depth,
+		const Tolerance& tolerance,
+		std::vector<float>& params,
+		std::vector<glm::vec3>& points)
+	{
+		const float m = 0.5f * (a + b);
+		const glm::vec3 pm = curve(m);
+
+		if (depth >= tolerance.maxDepth || (depth >= tolerance.minDepth && isFlat(pa, pm, pb, tolerance)))
+		{
+			params.push_back(b);
+			points.push_back(pb);
+			return;
+		}
+
+		subdivide(curve, a, m, pa, pm, depth + 1, tolerance, params, points);
+		subdivide(curve, m, b, pm, pb, depth + 1, tolerance, params, points);
+	}
+
+	bool CurveFlattener::isFlat(const glm::vec3& pa, const glm::vec3& pm, const glm::vec3& pb, const Tolerance& tolerance)
+	{
+		const glm::vec3 first = pm - pa;
+		const glm::vec3 second = pb - pm;
+
+		if (tolerance.chord > 0.f)
+		{
+			const glm::vec3 chord = pb - pa;
+			const float chordLength = glm::length(chord);
+			const float deviation = chordLength > 0.f
+				? glm::length(glm::cross(first, chord)) / chordLength
+				: glm::length(first);
+			if (deviation > tolerance.chord)
+				return false;
+		}
+
+		if (tolerance.angle > 0.f)
+		{
+			const float lengths = glm::length(first) * glm::length(second);
+			if (lengths > 0.f)
+			{
+				const float cosine = glm::dot(first, second) / lengths;
+				if (cosine < std::cos(tolerance.angle))
+					return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace assignment
+{
+	// Turns a parametric curve into a polyline that is only as dense as its shape requires.
+	// Every interval is split at its midpoint until the midpoint lies within the chord tolerance
+	// of the chord and the polyline turns by less than the angle tolerance there.
+	class CurveFlattener
+	{
+	public:
+		using Curve = std::function<glm::vec3(float)>;
+
+		struct Tolerance
+		{
+			// Maximum distance of the curve from the polyline; 0 disables the test.
+			float chord = 0.0005f;
+			// Maximum turning angle between two consecutive polyline segments, in radians; 0 disables the test.
+			float angle = 0.f;
+			// Every interval between breakpoints is halved at least this many times, so symmetric
+			// S-bends whose midpoint happens to lie on the chord are not mistaken for straight runs.
+			uint32_t minDepth = 2;
+			uint32_t maxDepth = 12;
+		};
+
+	public:
+		// breakpoints are the increasing parameters where the curve may lose smoothness (knots, segment ends);
+		// they are always part of the output. params and points receive the sampled polyline.
+		static void flatten(
+			const Curve& curve,
+			const std::vector<float>& breakpoints,
+			const Tolerance& tolerance,
+			std::vector<float>& params,
+			std::vector<glm::vec3>& points);
+
+	private:
+		static void subdivide(
+			const Curve& curve,
+			float a, float b,
+			const glm::vec3& pa, const glm::vec3& pb,
+			uint32_t depth,
+			const Tolerance& tolerance,
+			std::vector<float>& params,
+			std::vector<glm::vec3>& points);
+
+		static bool isFlat(const glm::vec3& pa, const glm::vec3& pm, const glm::vec3& pb, const Tolerance& tolerance);
+	};
+}
@@ -0,0 +1,62 @@
+#include "DeferredReleaseQueue.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace assignment
+{
+	DeferredReleaseQueue::DeferredReleaseQueue(Device& device)
+		: device(device)
+	{
+	}
+
+	DeferredReleaseQueue::~DeferredReleaseQueue()
+	{
+		collect();
+		for (Batch& batch : batches)
+		{
+			vkWaitForFences(device.device(), 1, &batch.fence, VK_TRUE, UINT64_MAX);
+			vkDestroyFence(device.device(), batch.fence, nullptr);
+		}
+	}
+
+	void DeferredReleaseQueue::retire(std::shared_ptr<void> resource)
+	{
+		if (resource)
+			pending.push_back(std::move(resource));
+	}
+
+	void DeferredReleaseQueue::collect()
+	{
+		if (!pending.empty())
+		{
+			VkFenceCreateInfo fenceInfo{};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+			VkFence fence;
+			if (vkCreateFence(device.device(), &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+				throw std::runtime_error("Failed to create release fence");
+
+			// An empty submission signals its fence after all work submitted before it.
+			if (vkQueueSubmit(device.graphicsQueue(), 0, nullptr, fence) != VK_SUCCESS)
+			{
+				vkDestroyFence(device.device(), fence, nullptr);
+				throw std::runtime_error("Failed to submit release fence");
+			}
+
+			batches.push_back({ std::exchange(pending, {}), fence });
+		}
+
+		for (auto it = batches.begin(); it != batches.end();)
+		{
+			if (vkGetFenceStatus(device.device(), it->fence) != VK_SUCCESS)
+			{
+				++it;
+				continue;
+			}
+
+			vkDestroyFence(device.device(), it->fence, nullptr);
+			it = batches.erase(it);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Device.h"
+
+#include <memory>
+#include <vector>
+
+namespace assignment
+{
+	// Keeps replaced GPU resources alive until the frames that may still read them have completed.
+	// collect() closes what was retired since its last call with a fence behind all submitted work
+	// and frees the batches whose fence has signaled; call it once per frame after the submit.
+	class DeferredReleaseQueue
+	{
+	public:
+		explicit DeferredReleaseQueue(Device& device);
+		~DeferredReleaseQueue();
+
+		NO_COPY_NO_MOVE(DeferredReleaseQueue);
+
+	public:
+		void retire(std::shared_ptr<void> resource);
+		void collect();
+
+	private:
+		struct Batch
+		{
+			std::vector<std::shared_ptr<void>> resources;
+			// Signaled once everything submitted before the batch was closed has completed.
+			VkFence fence;
+		};
+
+		Device& device;
+
+		std::vector<std::shared_ptr<void>> pending;
+		std::vector<Batch> batches;
+	};
+}
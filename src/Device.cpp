@@ -57,9 +57,11 @@ namespace assignment
 		pickPhysicalDevice();
 		createLogicalDevice();
 		createCommandPool();
+		memoryAllocator = std::make_unique<MemoryAllocator>(m_device, physicalDevice);
 	}
 
 	Device::~Device() {
+		memoryAllocator.reset();
 		vkDestroyCommandPool(m_device, commandPool, nullptr);
 		vkDestroyDevice(m_device, nullptr);
 
@@ -151,10 +153,16 @@ namespace assignment
 			queueCreateInfos.push_back(queueCreateInfo);
 		}
 
+		VkPhysicalDeviceFeatures supportedFeatures;
+		vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
 		deviceFeatures.fillModeNonSolid = VK_TRUE;
-		deviceFeatures.wideLines = VK_TRUE;
+		deviceFeatures.wideLines = supportedFeatures.wideLines;
+		deviceFeatures.shaderClipDistance = supportedFeatures.shaderClipDistance;
+		deviceFeatures.tessellationShader = supportedFeatures.tessellationShader;
+		enabledFeatures = deviceFeatures;
 
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -327,7 +335,8 @@ namespace assignment
 
 		int i = 0;
 		for (const auto& queueFamily : queueFamilies) {
-			if (queueFamily.queueCount > 0 && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+			// Compute dispatches are recorded into the same command buffers as the draws.
+			if (queueFamily.queueCount > 0 && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
 				indices.graphicsFamily = i;
 				indices.graphicsFamilyHasValue = true;
 			}
@@ -408,7 +417,7 @@ namespace assignment
 		VkBufferUsageFlags usage,
 		VkMemoryPropertyFlags properties,
 		VkBuffer& buffer,
-		VkDeviceMemory& bufferMemory)
+		MemoryAllocator::Allocation& bufferMemory)
 	{
 		VkBufferCreateInfo bufferInfo{};
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -422,15 +431,9 @@ namespace assignment
 		VkMemoryRequirements memRequirements;
 		vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-		if (vkAllocateMemory(m_device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
-			throw std::runtime_error("failed to allocate vertex buffer memory!");
+		bufferMemory = memoryAllocator->allocate(memRequirements, properties, true);
 
-		vkBindBufferMemory(m_device, buffer, bufferMemory, 0);
+		vkBindBufferMemory(m_device, buffer, bufferMemory.memory, bufferMemory.offset);
 	}
 
 	VkCommandBuffer Device::beginSingleTimeCommands() {
@@ -508,7 +511,7 @@ namespace assignment
 		const VkImageCreateInfo& imageInfo,
 		VkMemoryPropertyFlags properties,
 		VkImage& image,
-		VkDeviceMemory& imageMemory)
+		MemoryAllocator::Allocation& imageMemory)
 	{
 
 		if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
@@ -518,16 +521,9 @@ namespace assignment
 		VkMemoryRequirements memRequirements;
 		vkGetImageMemoryRequirements(m_device, image, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-		if (vkAllocateMemory(m_device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-			throw std::runtime_error("failed to allocate image memory!");
-		}
+		imageMemory = memoryAllocator->allocate(memRequirements, properties, imageInfo.tiling == VK_IMAGE_TILING_LINEAR);
 
-		if (vkBindImageMemory(m_device, image, imageMemory, 0) != VK_SUCCESS) {
+		if (vkBindImageMemory(m_device, image, imageMemory.memory, imageMemory.offset) != VK_SUCCESS) {
 			throw std::runtime_error("failed to bind image memory!");
 		}
 	}
@@ -3,8 +3,10 @@
 #include "Window.h"
 
 #include "BaseClassDefines.h"
+#include "MemoryAllocator.h"
 
 // std lib headers
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -45,6 +47,8 @@ namespace assignment
 		VkQueue presentQueue() const { return m_presentQueue; }
 		VkInstance getInstance() const { return instance; }
 		VkPhysicalDevice getPhysicalDevice() const { return physicalDevice; }
+		// Optional features, only enabled where the physical device has them.
+		const VkPhysicalDeviceFeatures& getEnabledFeatures() const { return enabledFeatures; }
 
 		SwapChainSupportDetails getSwapChainSupport() { return querySwapChainSupport(physicalDevice); }
 		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
@@ -53,12 +57,13 @@ namespace assignment
 			const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
 		// Buffer Helper Functions
+		// Buffers and images are bound at an offset into memory shared with other resources; free it with freeMemory.
 		void createBuffer(
 			VkDeviceSize size,
 			VkBufferUsageFlags usage,
 			VkMemoryPropertyFlags properties,
 			VkBuffer& buffer,
-			VkDeviceMemory& bufferMemory);
+			MemoryAllocator::Allocation& bufferMemory);
 		VkCommandBuffer beginSingleTimeCommands();
 		void endSingleTimeCommands(VkCommandBuffer commandBuffer);
 		void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
@@ -69,7 +74,9 @@ namespace assignment
 			const VkImageCreateInfo& imageInfo,
 			VkMemoryPropertyFlags properties,
 			VkImage& image,
-			VkDeviceMemory& imageMemory);
+			MemoryAllocator::Allocation& imageMemory);
+		void freeMemory(MemoryAllocator::Allocation& memory) { memoryAllocator->free(memory); }
+		MemoryAllocator::Statistics getMemoryStatistics() const { return memoryAllocator->getStatistics(); }
 
 		VkPhysicalDeviceProperties properties;
 
@@ -102,6 +109,8 @@ namespace assignment
 		VkSurfaceKHR m_surface;
 		VkQueue m_graphicsQueue;
 		VkQueue m_presentQueue;
+		VkPhysicalDeviceFeatures enabledFeatures{};
+		std::unique_ptr<MemoryAllocator> memoryAllocator;
 
 		const std::vector<const char*> validationLayers = { "VK_LAYER_KHRONOS_validation" };
 		const std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
@@ -3,6 +3,7 @@
 #include "BaseClassDefines.h"
 #include "Model.h"
 #include "Line.h"
+#include "LineBatch.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -49,9 +50,12 @@ namespace assignment
 
 		std::shared_ptr<Model> model{};
 		std::shared_ptr<Line> line{};
+		std::shared_ptr<LineBatch> lineBatch{};
 		glm::vec3 color{};
 		TransformComponent transform{};
 		bool visible = true;
+		// Cut by the clip planes of the global UBO, where the device supports clip distances.
+		bool clipped = false;
 
 	private:
 		GameObject(id_t objId) : id(objId) { name = std::to_string(objId); }
@@ -17,7 +17,61 @@ namespace assignment
 			createIndexBuffers(*indices);
 	}
 
-	std::vector<VkVertexInputBindingDescription> GraphicsPrimitive::Vertex::getBindingDescriptions()
+	GraphicsPrimitive::GraphicsPrimitive(Device& device, uint32_t vertexCount, VkBufferUsageFlags usage)
+		: device(device), vertexCount(vertexCount)
+	{
+		assert(vertexCount >= 2 && "Vertex count should at least be 2");
+
+		vertexBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(Vertex),
+			vertexCount,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | usage,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	}
+
+	GraphicsPrimitive::GraphicsPrimitive(Device& device, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, DeferredUpload)
+		: device(device), vertexCount(uint32_t(vertices.size())), indexCount(uint32_t(indices.size()))
+	{
+		assert(vertexCount >= 2 && "Vertex count should at least be 2");
+
+		vertexStagingBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(Vertex),
+			vertexCount,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		vertexStagingBuffer->map();
+		vertexStagingBuffer->writeToBuffer((void*)vertices.data());
+
+		vertexBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(Vertex),
+			vertexCount,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		hasIndexBuffer = indexCount > 0;
+		if (!hasIndexBuffer) return;
+
+		indexStagingBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(uint32_t),
+			indexCount,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		indexStagingBuffer->map();
+		indexStagingBuffer->writeToBuffer((void*)indices.data());
+
+		indexBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(uint32_t),
+			indexCount,
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	}
+
+	std::vector<VkVertexInputBindingDescription> GraphicsPrimitive::getBindingDescriptions()
 	{
 		std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
 		bindingDescriptions[0].binding = 0;
@@ -27,7 +81,7 @@ namespace assignment
 		return bindingDescriptions;
 	}
 
-	std::vector<VkVertexInputAttributeDescription> GraphicsPrimitive::Vertex::getAttributeDescriptions()
+	std::vector<VkVertexInputAttributeDescription> GraphicsPrimitive::getAttributeDescriptions()
 	{
 		std::vector<VkVertexInputAttributeDescription> attributeDescriptions(4);
 
@@ -131,4 +185,130 @@ namespace assignment
 
 		device.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
 	}
+
+	VkDeviceSize GraphicsPrimitive::getMemorySize() const
+	{
+		VkDeviceSize size = vertexBuffer->getBufferSize();
+		if (hasIndexBuffer)
+			size += indexBuffer->getBufferSize();
+		return size;
+	}
+
+	void GraphicsPrimitive::recordUpload(VkCommandBuffer commandBuffer)
+	{
+		assert(vertexStagingBuffer && "Primitive has no deferred upload");
+
+		std::vector<VkBufferMemoryBarrier> barriers;
+		auto copy = [&](Buffer& staging, Buffer& target, VkAccessFlags access)
+		{
+			VkBufferCopy region{};
+			region.size = staging.getBufferSize();
+			vkCmdCopyBuffer(commandBuffer, staging.getBuffer(), target.getBuffer(), 1, &region);
+
+			VkBufferMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = access;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.buffer = target.getBuffer();
+			barrier.offset = 0;
+			barrier.size = VK_WHOLE_SIZE;
+			barriers.push_back(barrier);
+		};
+
+		copy(*vertexStagingBuffer, *vertexBuffer, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+		if (indexStagingBuffer)
+			copy(*indexStagingBuffer, *indexBuffer, VK_ACCESS_INDEX_READ_BIT);
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			0,
+			0, nullptr,
+			uint32_t(barriers.size()), barriers.data(),
+			0, nullptr);
+	}
+
+	void GraphicsPrimitive::releaseStagingBuffers()
+	{
+		vertexStagingBuffer.reset();
+		indexStagingBuffer.reset();
+	}
+
+	void GraphicsPrimitive::updateVertices(const std::vector<Vertex>& vertices, const std::vector<VertexRange>& ranges)
+	{
+		assert(vertices.size() == vertexCount && "Vertex update cannot change the vertex count");
+
+		uint32_t updatedCount = 0;
+		for (const auto& range : ranges)
+			updatedCount += range.count;
+		if (updatedCount == 0)
+			return;
+
+		const VkDeviceSize vertexSize = sizeof(Vertex);
+		Buffer stagingBuffer(
+			device,
+			vertexSize,
+			updatedCount,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		stagingBuffer.map();
+
+		std::vector<VkBufferCopy> regions;
+		regions.reserve(ranges.size());
+		VkDeviceSize stagingOffset = 0;
+		for (const auto& range : ranges)
+		{
+			if (range.count == 0)
+				continue;
+			assert(range.first + range.count <= vertexCount && "Vertex range is out of bounds");
+
+			const VkDeviceSize size = vertexSize * range.count;
+			stagingBuffer.writeToBuffer((void*)&vertices[range.first], size, stagingOffset);
+
+			VkBufferCopy region{};
+			region.srcOffset = stagingOffset;
+			region.dstOffset = vertexSize * range.first;
+			region.size = size;
+			regions.push_back(region);
+
+			stagingOffset += size;
+		}
+
+		VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
+
+		// Frames still in flight may be reading the buffer we are about to overwrite.
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = vertexBuffer->getBuffer();
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr);
+
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), uint32_t(regions.size()), regions.data());
+
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr);
+
+		device.endSingleTimeCommands(commandBuffer);
+	}
 }
\ No newline at end of file
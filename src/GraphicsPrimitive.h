@@ -4,14 +4,7 @@
 #include "Buffer.h"
 #include "ImageTexture.h"
 
-#include "utils.h"
-
-#define GLM_FORCE_RADIANS
-#define GLM_FORCE_DEPTH_ZERO_TO_ONE
-#include "glm/glm.hpp"
-
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+#include "Vertex.h"
 
 #include <memory>
 #include <vector>
@@ -21,23 +14,10 @@ namespace assignment
 	class GraphicsPrimitive
 	{
 	public:
-		struct Vertex {
-			glm::vec3 position{};
-			glm::vec3 color{};
-			glm::vec3 normal{};
-			glm::vec2 uv{};
-
-			static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
-			static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
-
-			bool operator ==(const Vertex& other) const
-			{
-				return position == other.position &&
-					color == other.color &&
-					normal == other.normal &&
-					uv == other.uv;
-			}
-		};
+		using Vertex = assignment::Vertex;
+
+		static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+		static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
 
 		struct Builder
 		{
@@ -45,7 +25,21 @@ namespace assignment
 			std::vector<uint32_t> indices{};
 		};
 
+		struct VertexRange
+		{
+			uint32_t first = 0;
+			uint32_t count = 0;
+		};
+
+		// Selects the constructor that leaves the copy from the staging buffers to recordUpload.
+		struct DeferredUpload {};
+
 		GraphicsPrimitive(Device& device, const std::vector<Vertex>& vertices, const std::vector<uint32_t>* indices = nullptr);
+		// Uninitialized device-local vertex buffer that is written on the GPU; usage is added to the vertex buffer usage.
+		GraphicsPrimitive(Device& device, uint32_t vertexCount, VkBufferUsageFlags usage);
+		// Creates the device-local buffers and fills the staging buffers without touching a queue, so it may run on a worker thread.
+		GraphicsPrimitive(Device& device, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, DeferredUpload);
+		virtual ~GraphicsPrimitive() = default;
 
 	public:
 		void bind(VkCommandBuffer commandBuffer);
@@ -54,6 +48,19 @@ namespace assignment
 		virtual void createVertexBuffers(const std::vector<Vertex>& vertices);
 		virtual void createIndexBuffers(const std::vector<uint32_t>& indices);
 
+		// Records the copies of a deferred upload and a barrier for the vertex input. The staging buffers
+		// must live until the command buffer has completed, after that releaseStagingBuffers frees them.
+		void recordUpload(VkCommandBuffer commandBuffer);
+		void releaseStagingBuffers();
+
+		// Uploads only the given ranges of vertices into the existing vertex buffer.
+		void updateVertices(const std::vector<Vertex>& vertices, const std::vector<VertexRange>& ranges);
+
+		Buffer& getVertexBuffer() const { return *vertexBuffer; }
+		uint32_t getVertexCount() const { return vertexCount; }
+		// Size of the vertex and index buffers.
+		VkDeviceSize getMemorySize() const;
+
 	protected:
 		Device& device;
 
@@ -63,25 +70,8 @@ namespace assignment
 		bool hasIndexBuffer = false;
 		std::unique_ptr<Buffer> indexBuffer;
 		uint32_t indexCount;
-	};
-}
 
-namespace std
-{
-	template<>
-	struct hash<assignment::GraphicsPrimitive::Vertex> {
-		size_t operator()(assignment::GraphicsPrimitive::Vertex const& vertex) const
-		{
-			size_t seed = 0;
-			assignment::hashCombine(
-				seed,
-				vertex.position,
-				vertex.color,
-				vertex.normal,
-				vertex.uv
-			);
-			return seed;
-		}
+		std::unique_ptr<Buffer> vertexStagingBuffer;
+		std::unique_ptr<Buffer> indexStagingBuffer;
 	};
 }
-
@@ -19,7 +19,7 @@ namespace assignment
 	{
 		vkDestroyImageView(device.device(), textureImageView, nullptr);
 		vkDestroyImage(device.device(), textureImage, nullptr);
-		vkFreeMemory(device.device(), textureImageMemory, nullptr);
+		device.freeMemory(textureImageMemory);
 
 		vkDestroySampler(device.device(), textureSampler, nullptr);
 	}
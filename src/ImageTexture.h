@@ -33,7 +33,7 @@ namespace assignment
 		std::string filepath;
 
 		VkImage textureImage;
-		VkDeviceMemory textureImageMemory;
+		MemoryAllocator::Allocation textureImageMemory{};
 		VkImageView textureImageView;
 		VkSampler textureSampler;
 
@@ -0,0 +1,122 @@
+#include "LineBatch.h"
+
+#include "SwapChain.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace assignment
+{
+	uint32_t LineBatch::Builder::addGroup(const std::string& name, const std::vector<Vertex>& segmentVertices, uint32_t capacity)
+	{
+		assert(segmentVertices.size() % 2 == 0 && capacity % 2 == 0 && "Segments need two vertices each");
+
+		Group group{};
+		group.name = name;
+		group.range.first = uint32_t(vertices.size());
+		group.range.count = std::max(capacity, uint32_t(segmentVertices.size()));
+		group.count = uint32_t(segmentVertices.size());
+
+		vertices.insert(vertices.end(), segmentVertices.begin(), segmentVertices.end());
+		vertices.resize(size_t(group.range.first) + group.range.count);
+		groups.push_back(std::move(group));
+		return uint32_t(groups.size() - 1);
+	}
+
+	LineBatch::LineBatch(Device& device, const Builder& builder)
+		: GraphicsPrimitive(device, builder.vertices), groups(builder.groups), stagingBuffers(SwapChain::MAX_FRAMES_IN_FLIGHT)
+	{}
+
+	LineBatch::~LineBatch() {}
+
+	void LineBatch::drawVisibleGroups(VkCommandBuffer commandBuffer)
+	{
+		bind(commandBuffer);
+		for (const VertexRange& range : getVisibleRanges())
+			vkCmdDraw(commandBuffer, range.count, 1, range.first, 0);
+	}
+
+	std::vector<GraphicsPrimitive::VertexRange> LineBatch::getVisibleRanges() const
+	{
+		std::vector<VertexRange> ranges;
+		for (const Group& group : groups)
+		{
+			if (!group.visible || group.count == 0)
+				continue;
+
+			if (!ranges.empty() && ranges.back().first + ranges.back().count == group.range.first)
+				ranges.back().count += group.count;
+			else
+				ranges.push_back({ group.range.first, group.count });
+		}
+		return ranges;
+	}
+
+	void LineBatch::setGroupVertices(VkCommandBuffer commandBuffer, int frameIndex, uint32_t group, const std::vector<Vertex>& segmentVertices)
+	{
+		Group& target = groups[group];
+		assert(segmentVertices.size() % 2 == 0 && "Segments need two vertices each");
+		assert(segmentVertices.size() <= target.range.count && "Segments do not fit into the group");
+
+		target.count = uint32_t(segmentVertices.size());
+		if (target.count == 0)
+			return;
+
+		// The frame's last submission has completed, so its staging buffer is free to reuse or replace.
+		std::unique_ptr<Buffer>& stagingBuffer = stagingBuffers[frameIndex];
+		if (!stagingBuffer || stagingBuffer->getInstanceCount() < target.count)
+		{
+			stagingBuffer = std::make_unique<Buffer>(
+				device,
+				sizeof(Vertex),
+				target.range.count,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			stagingBuffer->map();
+		}
+		const VkDeviceSize size = sizeof(Vertex) * target.count;
+		stagingBuffer->writeToBuffer((void*)segmentVertices.data(), size);
+
+		// Earlier frames may still draw from the range being overwritten.
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = vertexBuffer->getBuffer();
+		barrier.offset = sizeof(Vertex) * target.range.first;
+		barrier.size = size;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr);
+
+		VkBufferCopy region{};
+		region.dstOffset = barrier.offset;
+		region.size = size;
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer->getBuffer(), vertexBuffer->getBuffer(), 1, &region);
+
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr);
+	}
+
+	uint32_t LineBatch::findGroup(const std::string& name) const
+	{
+		const auto it = std::find_if(groups.begin(), groups.end(), [&name](const Group& group) { return group.name == name; });
+		assert(it != groups.end() && "No group with that name");
+		return uint32_t(it - groups.begin());
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GraphicsPrimitive.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace assignment
+{
+	// Many line segments in one vertex buffer, drawn as a line list. The segments are split into named groups
+	// that are shown, hidden and rewritten on their own, and every visible group is a single draw.
+	class LineBatch : public GraphicsPrimitive
+	{
+	public:
+		struct Group
+		{
+			std::string name{};
+			// Vertices reserved for the group; only the first count are drawn.
+			VertexRange range{};
+			uint32_t count = 0;
+			bool visible = true;
+		};
+
+		struct Builder
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<Group> groups{};
+
+			// Appends a group drawing vertices as segments, with room for capacity vertices (even) so it can grow later.
+			uint32_t addGroup(const std::string& name, const std::vector<Vertex>& segmentVertices, uint32_t capacity = 0);
+		};
+
+		LineBatch(Device& device, const Builder& builder);
+		~LineBatch();
+
+		NO_COPY(LineBatch);
+
+	public:
+		// Binds the vertex buffer once and draws the visible groups.
+		void drawVisibleGroups(VkCommandBuffer commandBuffer);
+		// Vertices of the visible groups, neighbouring groups merged wherever no unused reserved vertices lie between them.
+		std::vector<VertexRange> getVisibleRanges() const;
+
+		// Replaces the segments of a group; they have to fit into the vertices reserved for it.
+		// The copy goes through the frame's staging buffer and is recorded into its command buffer,
+		// outside of a render pass, so nothing waits on the queue.
+		void setGroupVertices(VkCommandBuffer commandBuffer, int frameIndex, uint32_t group, const std::vector<Vertex>& segmentVertices);
+
+		uint32_t findGroup(const std::string& name) const;
+		Group& getGroup(uint32_t group) { return groups[group]; }
+		const std::vector<Group>& getGroups() const { return groups; }
+
+	private:
+		std::vector<Group> groups;
+		// One per frame in flight, since a frame's copy may still be pending while the next one writes.
+		std::vector<std::unique_ptr<Buffer>> stagingBuffers;
+	};
+}
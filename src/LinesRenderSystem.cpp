@@ -25,7 +25,8 @@ namespace assignment
 
 	void LinesRenderSystem::renderLineObjects(FrameInfo& frameInfo, std::vector<GameObject>& gameObjects)
 	{
-		pipeline->bind(frameInfo.commandBuffer);
+		Pipeline* boundPipeline = pipeline.get();
+		boundPipeline->bind(frameInfo.commandBuffer);
 
 		vkCmdBindDescriptorSets(
 			frameInfo.commandBuffer,
@@ -37,9 +38,17 @@ namespace assignment
 
 		for (auto& obj : gameObjects)
 		{
-			if (!obj.visible)
+			if (!obj.visible || (!obj.line && !obj.lineBatch))
 				continue;
 
+			Pipeline* objectPipeline = selectPipeline(obj);
+			if (objectPipeline != boundPipeline)
+			{
+				// All pipelines share the layout, so the global descriptor set stays bound.
+				boundPipeline = objectPipeline;
+				boundPipeline->bind(frameInfo.commandBuffer);
+			}
+
 			SimplePushConstantData push{};
 			push.modelMatrix = obj.transform.mat4();
 			push.normalMatrix = obj.transform.normalMatrix();
@@ -52,6 +61,12 @@ namespace assignment
 				sizeof(SimplePushConstantData),
 				&push);
 
+			if (obj.lineBatch)
+			{
+				obj.lineBatch->drawVisibleGroups(frameInfo.commandBuffer);
+				continue;
+			}
+
 			obj.line->bind(frameInfo.commandBuffer);
 			obj.line->draw(frameInfo.commandBuffer);
 		}
@@ -94,7 +109,8 @@ namespace assignment
 		pipelineConfig.rasterizationInfo.depthBiasConstantFactor = 0.0f;  // Optional
 		pipelineConfig.rasterizationInfo.depthBiasClamp = 0.0f;           // Optional
 		pipelineConfig.rasterizationInfo.depthBiasSlopeFactor = 0.0f;     // Optional
-		pipelineConfig.rasterizationInfo.lineWidth = 2.f;
+		// Wider lines only where the device has wideLines; ThickLinesRenderSystem draws any width without it.
+		pipelineConfig.rasterizationInfo.lineWidth = device.getEnabledFeatures().wideLines ? 2.f : 1.f;
 
 		pipelineConfig.renderPass = renderPass;
 		pipelineConfig.pipelineLayout = pipelineLayout;
@@ -103,6 +119,36 @@ namespace assignment
 			"shaders/splineVert.spv",
 			"shaders/splineFrag.spv",
 			pipelineConfig);
+
+		if (device.getEnabledFeatures().shaderClipDistance)
+			clippedPipeline = std::make_shared<Pipeline>(
+				device,
+				"shaders/splineClippedVert.spv",
+				"shaders/splineFrag.spv",
+				pipelineConfig);
+
+		pipelineConfig.inputAssemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+		pipelineConfig.inputAssemblyInfo.primitiveRestartEnable = VK_TRUE;
+		stripPipeline = std::make_shared<Pipeline>(
+			device,
+			"shaders/splineVert.spv",
+			"shaders/splineFrag.spv",
+			pipelineConfig);
+
+		if (device.getEnabledFeatures().shaderClipDistance)
+			clippedStripPipeline = std::make_shared<Pipeline>(
+				device,
+				"shaders/splineClippedVert.spv",
+				"shaders/splineFrag.spv",
+				pipelineConfig);
+	}
+
+	Pipeline* LinesRenderSystem::selectPipeline(const GameObject& obj) const
+	{
+		const bool strip = obj.line && obj.line->getTopology() == Line::Topology::LineStrip;
+		if (obj.clipped && clippedPipeline)
+			return strip ? clippedStripPipeline.get() : clippedPipeline.get();
+		return strip ? stripPipeline.get() : pipeline.get();
 	}
 
 }
\ No newline at end of file
@@ -25,11 +25,17 @@ namespace assignment
 	private:
 		void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
 		void createPipeline(VkRenderPass renderPass);
+		Pipeline* selectPipeline(const GameObject& obj) const;
 
 	private:
 		Device& device;
 
 		std::shared_ptr<Pipeline> pipeline;
+		// Same shaders for lines with Line::Topology::LineStrip, with primitive restart.
+		std::shared_ptr<Pipeline> stripPipeline;
+		// Both again for GameObject::clipped; only created when the device has shaderClipDistance.
+		std::shared_ptr<Pipeline> clippedPipeline;
+		std::shared_ptr<Pipeline> clippedStripPipeline;
 		VkPipelineLayout pipelineLayout;
 	};
 }
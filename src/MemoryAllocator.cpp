@@ -0,0 +1,251 @@
+#include "MemoryAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <stdexcept>
+
+namespace assignment
+{
+	// Level l splits the block into ranges of size >> l; free ranges are kept per level, ordered
+	// by offset so allocations pack towards the start of the block.
+	struct MemoryAllocator::Block
+	{
+		uint32_t pool = 0;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr;
+		uint32_t allocationCount = 0;
+		std::vector<std::set<VkDeviceSize>> freeOffsets;
+
+		Block(uint32_t pool, VkDeviceMemory memory, VkDeviceSize size, void* mapped)
+			: pool(pool), memory(memory), size(size), mapped(mapped),
+			freeOffsets(std::countr_zero(size) - std::countr_zero(MIN_ALLOCATION_SIZE) + 1)
+		{
+			freeOffsets[0].insert(0);
+		}
+
+		bool allocate(uint32_t level, VkDeviceSize& offset)
+		{
+			// The smallest free range that is large enough, split in halves down to the requested level.
+			uint32_t found = level + 1;
+			while (found > 0 && freeOffsets[found - 1].empty())
+				found--;
+			if (found == 0)
+				return false;
+
+			uint32_t current = found - 1;
+			offset = *freeOffsets[current].begin();
+			freeOffsets[current].erase(freeOffsets[current].begin());
+			while (current < level)
+			{
+				current++;
+				freeOffsets[current].insert(offset + (size >> current));
+			}
+			allocationCount++;
+			return true;
+		}
+
+		void free(VkDeviceSize offset, uint32_t level)
+		{
+			while (level > 0)
+			{
+				const auto buddy = freeOffsets[level].find(offset ^ (size >> level));
+				if (buddy == freeOffsets[level].end())
+					break;
+				offset = std::min(offset, *buddy);
+				freeOffsets[level].erase(buddy);
+				level--;
+			}
+			freeOffsets[level].insert(offset);
+			allocationCount--;
+		}
+	};
+
+	MemoryAllocator::MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize)
+		: device(device)
+	{
+		assert(std::has_single_bit(blockSize) && blockSize >= MIN_ALLOCATION_SIZE && "Block size must be a power of two");
+
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		nonCoherentAtomSize = std::max<VkDeviceSize>(1, properties.limits.nonCoherentAtomSize);
+
+		// Small heaps, e.g. host visible device memory, get smaller blocks so a few of them still fit.
+		blockSizes.resize(memoryProperties.memoryTypeCount);
+		pools.resize(2 * size_t(memoryProperties.memoryTypeCount));
+		for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+		{
+			const VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[type].heapIndex].size;
+			blockSizes[type] = std::max(MIN_ALLOCATION_SIZE, std::min(blockSize, std::bit_floor(heapSize / 8)));
+			for (uint32_t linear = 0; linear < 2; linear++)
+			{
+				pools[2 * type + linear].memoryType = type;
+				pools[2 * type + linear].linear = linear;
+			}
+		}
+	}
+
+	MemoryAllocator::~MemoryAllocator()
+	{
+		for (Pool& pool : pools)
+			for (const std::unique_ptr<Block>& block : pool.blocks)
+				freeMemory(block->memory, block->mapped != nullptr);
+	}
+
+	MemoryAllocator::Allocation MemoryAllocator::allocate(
+		const VkMemoryRequirements& requirements,
+		VkMemoryPropertyFlags properties,
+		bool linear)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+		const VkMemoryPropertyFlags typeFlags = memoryProperties.memoryTypes[memoryType].propertyFlags;
+		const bool nonCoherent = (typeFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(typeFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		const VkDeviceSize atomSize = nonCoherent ? nonCoherentAtomSize : 1;
+
+		const VkDeviceSize size = (requirements.size + atomSize - 1) / atomSize * atomSize;
+		const VkDeviceSize reserved = std::max(MIN_ALLOCATION_SIZE, std::bit_ceil(std::max({ size, requirements.alignment, atomSize })));
+		const VkDeviceSize blockSize = blockSizes[memoryType];
+		if (reserved > blockSize / 2)
+			return allocateDedicated(memoryType, size);
+
+		const uint32_t poolIndex = 2 * memoryType + (linear ? 1 : 0);
+		Pool& pool = pools[poolIndex];
+		const uint32_t level = uint32_t(std::countr_zero(blockSize) - std::countr_zero(reserved));
+
+		Block* block = nullptr;
+		VkDeviceSize offset = 0;
+		for (const std::unique_ptr<Block>& candidate : pool.blocks)
+		{
+			if (candidate->allocate(level, offset))
+			{
+				block = candidate.get();
+				break;
+			}
+		}
+		if (!block)
+		{
+			void* mapped = nullptr;
+			const VkDeviceMemory memory = allocateMemory(memoryType, blockSize, &mapped);
+			pool.blocks.push_back(std::make_unique<Block>(poolIndex, memory, blockSize, mapped));
+			block = pool.blocks.back().get();
+			block->allocate(level, offset);
+
+			statistics.blockCount++;
+			statistics.blockBytes += blockSize;
+		}
+
+		Allocation allocation{};
+		allocation.memory = block->memory;
+		allocation.offset = offset;
+		allocation.size = size;
+		allocation.mapped = block->mapped ? static_cast<char*>(block->mapped) + offset : nullptr;
+		allocation.block = block;
+		allocation.level = level;
+
+		statistics.allocationCount++;
+		statistics.usedBytes += size;
+		statistics.reservedBytes += reserved;
+		return allocation;
+	}
+
+	void MemoryAllocator::free(Allocation& allocation)
+	{
+		if (allocation.memory == VK_NULL_HANDLE)
+			return;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		statistics.allocationCount--;
+		statistics.usedBytes -= allocation.size;
+
+		Block* block = allocation.block;
+		if (!block)
+		{
+			freeMemory(allocation.memory, allocation.mapped != nullptr);
+			statistics.dedicatedCount--;
+			statistics.dedicatedBytes -= allocation.size;
+			allocation = {};
+			return;
+		}
+
+		block->free(allocation.offset, allocation.level);
+		statistics.reservedBytes -= block->size >> allocation.level;
+
+		// One empty block is kept per pool, so a resource that is recreated again and again does not allocate every time.
+		Pool& pool = pools[block->pool];
+		if (block->allocationCount == 0 && pool.blocks.size() > 1)
+		{
+			statistics.blockCount--;
+			statistics.blockBytes -= block->size;
+			freeMemory(block->memory, block->mapped != nullptr);
+			pool.blocks.erase(std::find_if(pool.blocks.begin(), pool.blocks.end(),
+				[block](const std::unique_ptr<Block>& candidate) { return candidate.get() == block; }));
+		}
+		allocation = {};
+	}
+
+	MemoryAllocator::Statistics MemoryAllocator::getStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return statistics;
+	}
+
+	uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+	{
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+		{
+			if ((typeFilter & (1 << i)) &&
+				(memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+				return i;
+		}
+
+		throw std::runtime_error("failed to find suitable memory type!");
+	}
+
+	VkDeviceMemory MemoryAllocator::allocateMemory(uint32_t memoryType, VkDeviceSize size, void** mapped)
+	{
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory;
+		if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate device memory!");
+
+		*mapped = nullptr;
+		if (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			if (vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, mapped) != VK_SUCCESS)
+			{
+				vkFreeMemory(device, memory, nullptr);
+				throw std::runtime_error("failed to map device memory!");
+			}
+		}
+		return memory;
+	}
+
+	void MemoryAllocator::freeMemory(VkDeviceMemory memory, bool mapped)
+	{
+		if (mapped)
+			vkUnmapMemory(device, memory);
+		vkFreeMemory(device, memory, nullptr);
+	}
+
+	MemoryAllocator::Allocation MemoryAllocator::allocateDedicated(uint32_t memoryType, VkDeviceSize size)
+	{
+		Allocation allocation{};
+		allocation.memory = allocateMemory(memoryType, size, &allocation.mapped);
+		allocation.size = size;
+
+		statistics.allocationCount++;
+		statistics.usedBytes += size;
+		statistics.dedicatedCount++;
+		statistics.dedicatedBytes += size;
+		return allocation;
+	}
+}
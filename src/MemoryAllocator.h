@@ -0,0 +1,98 @@
+#pragma once
+
+#include "BaseClassDefines.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace assignment
+{
+	// Sub-allocates device memory so that buffers and images do not each take one of the
+	// maxMemoryAllocationCount allocations. Every memory type gets a list of large blocks that are
+	// split by a buddy allocator: a request is rounded up to a power of two, which also aligns it,
+	// and freed halves merge with their buddy again. Buffers and optimal tiling images use separate
+	// blocks, so bufferImageGranularity never has to be checked. Requests larger than half a block
+	// get a dedicated allocation. Host visible blocks stay mapped for their whole lifetime, since
+	// a VkDeviceMemory cannot be mapped twice by the resources sharing it.
+	class MemoryAllocator
+	{
+		struct Block;
+
+	public:
+		struct Allocation
+		{
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			// Requested size, rounded up to nonCoherentAtomSize on non-coherent memory so whole allocations can be flushed.
+			VkDeviceSize size = 0;
+			// Address of offset in host visible memory, nullptr otherwise.
+			void* mapped = nullptr;
+
+		private:
+			friend class MemoryAllocator;
+			// nullptr for a dedicated allocation.
+			Block* block = nullptr;
+			uint32_t level = 0;
+		};
+
+		struct Statistics
+		{
+			uint32_t blockCount = 0;
+			uint32_t dedicatedCount = 0;
+			uint32_t allocationCount = 0;
+			// Device memory held by blocks and by dedicated allocations.
+			VkDeviceSize blockBytes = 0;
+			VkDeviceSize dedicatedBytes = 0;
+			// Sizes asked for, and the power of two ranges reserved for them in blocks.
+			VkDeviceSize usedBytes = 0;
+			VkDeviceSize reservedBytes = 0;
+		};
+
+		// Smallest range handed out of a block.
+		static constexpr VkDeviceSize MIN_ALLOCATION_SIZE = 256;
+
+		// blockSize is the preferred size of a block, reduced on small heaps; it must be a power of two.
+		MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize = VkDeviceSize(64) << 20);
+		~MemoryAllocator();
+
+		NO_COPY_NO_MOVE(MemoryAllocator);
+
+	public:
+		// linear is true for buffers and linear tiling images. Thread safe, like free().
+		Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear);
+		void free(Allocation& allocation);
+
+		Statistics getStatistics() const;
+
+	private:
+		struct Pool
+		{
+			uint32_t memoryType = 0;
+			bool linear = false;
+			std::vector<std::unique_ptr<Block>> blocks;
+		};
+
+		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+		VkDeviceMemory allocateMemory(uint32_t memoryType, VkDeviceSize size, void** mapped);
+		void freeMemory(VkDeviceMemory memory, bool mapped);
+		Allocation allocateDedicated(uint32_t memoryType, VkDeviceSize size);
+
+	private:
+		VkDevice device;
+		VkPhysicalDeviceMemoryProperties memoryProperties{};
+		VkDeviceSize nonCoherentAtomSize = 1;
+		// Per memory type, see MemoryAllocator().
+		std::vector<VkDeviceSize> blockSizes;
+
+		// Two per memory type: optimal images at 2 * type, linear resources at 2 * type + 1.
+		std::vector<Pool> pools;
+
+		mutable std::mutex mutex;
+		Statistics statistics{};
+	};
+}
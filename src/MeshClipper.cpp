@@ -0,0 +1,227 @@
+#include "MeshClipper.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <execution>
+#include <numeric>
+
+namespace assignment
+{
+	namespace
+	{
+		constexpr uint32_t CHUNK_TRIANGLES = 4096;
+		constexpr uint32_t FACE_COUNT = 6;
+		// A triangle cut by all six faces has at most 3 + 6 corners.
+		constexpr uint32_t MAX_POLYGON_SIZE = 3 + FACE_COUNT;
+		// Marks indices of vertices created in a chunk, before they are given their final place.
+		constexpr uint32_t NEW_VERTEX = 0x80000000u;
+
+		// Signed distance to face f, positive inside; faces 2 * axis and 2 * axis + 1 are the min and max side of axis.
+		float faceDistance(const MeshClipper::Box& box, uint32_t face, const glm::vec3& position)
+		{
+			const uint32_t axis = face / 2;
+			return face % 2 == 0 ? position[axis] - box.min[axis] : box.max[axis] - position[axis];
+		}
+
+		uint32_t outcode(const MeshClipper::Box& box, const glm::vec3& position)
+		{
+			uint32_t code = 0;
+			for (uint32_t face = 0; face < FACE_COUNT; face++)
+				if (faceDistance(box, face, position) < 0.f)
+					code |= 1u << face;
+			return code;
+		}
+
+		Vertex interpolate(const Vertex& a, const Vertex& b, float t)
+		{
+			Vertex result{};
+			result.position = glm::mix(a.position, b.position, t);
+			result.color = glm::mix(a.color, b.color, t);
+			result.normal = glm::mix(a.normal, b.normal, t);
+			const float normalLength = glm::length(result.normal);
+			if (normalLength > 0.f)
+				result.normal /= normalLength;
+			result.uv = glm::mix(a.uv, b.uv, t);
+			return result;
+		}
+
+		struct Corner
+		{
+			Vertex vertex;
+			// Index of the input vertex, or NEW_VERTEX for a point on a cut edge.
+			uint32_t index;
+		};
+
+		struct Polygon
+		{
+			std::array<Corner, MAX_POLYGON_SIZE> corners;
+			uint32_t size = 0;
+
+			void push(const Corner& corner) { corners[size++] = corner; }
+		};
+
+		struct Chunk
+		{
+			// Input vertex indices, or NEW_VERTEX | position in newVertices.
+			std::vector<uint32_t> indices;
+			std::vector<Vertex> newVertices;
+			size_t indexOffset = 0;
+			size_t newVertexOffset = 0;
+		};
+
+		void clipPolygon(const MeshClipper::Box& box, uint32_t face, const Polygon& polygon, Polygon& result)
+		{
+			result.size = 0;
+			for (uint32_t i = 0; i < polygon.size; i++)
+			{
+				const Corner& a = polygon.corners[i];
+				const Corner& b = polygon.corners[(i + 1) % polygon.size];
+				const float da = faceDistance(box, face, a.vertex.position);
+				const float db = faceDistance(box, face, b.vertex.position);
+
+				if (da >= 0.f)
+					result.push(a);
+				// Only a strict crossing makes a new corner, so a corner on the face is not added twice.
+				if ((da > 0.f && db < 0.f) || (da < 0.f && db > 0.f))
+					result.push({ interpolate(a.vertex, b.vertex, da / (da - db)), NEW_VERTEX });
+			}
+		}
+
+		void clipTriangle(
+			const std::vector<Vertex>& vertices,
+			const MeshClipper::Box& box,
+			const uint32_t triangle[3],
+			uint32_t crossedFaces,
+			Chunk& chunk)
+		{
+			Polygon polygons[2];
+			for (uint32_t k = 0; k < 3; k++)
+				polygons[0].push({ vertices[triangle[k]], triangle[k] });
+
+			uint32_t current = 0;
+			for (uint32_t face = 0; face < FACE_COUNT && polygons[current].size >= 3; face++)
+			{
+				if (!(crossedFaces & (1u << face)))
+					continue;
+				clipPolygon(box, face, polygons[current], polygons[1 - current]);
+				current = 1 - current;
+			}
+
+			const Polygon& polygon = polygons[current];
+			if (polygon.size < 3)
+				return;
+
+			uint32_t cornerIndices[MAX_POLYGON_SIZE];
+			for (uint32_t k = 0; k < polygon.size; k++)
+			{
+				const Corner& corner = polygon.corners[k];
+				if (corner.index != NEW_VERTEX)
+				{
+					cornerIndices[k] = corner.index;
+					continue;
+				}
+				cornerIndices[k] = NEW_VERTEX | uint32_t(chunk.newVertices.size());
+				chunk.newVertices.push_back(corner.vertex);
+			}
+
+			// The clipped polygon stays convex, so a fan keeps the winding of the triangle.
+			for (uint32_t k = 1; k + 1 < polygon.size; k++)
+				chunk.indices.insert(chunk.indices.end(), { cornerIndices[0], cornerIndices[k], cornerIndices[k + 1] });
+		}
+	}
+
+	void MeshClipper::clip(
+		const std::vector<Vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		const Box& box,
+		std::vector<Vertex>& resultVertices,
+		std::vector<uint32_t>& resultIndices)
+	{
+		assert(indices.size() % 3 == 0 && "Indices are not a triangle list");
+		assert(vertices.size() < NEW_VERTEX && "Too many vertices to mark the new ones");
+
+		const uint32_t vertexCount = uint32_t(vertices.size());
+		const uint32_t triangleCount = uint32_t(indices.size() / 3);
+
+		std::vector<uint32_t> chunkIds((triangleCount + CHUNK_TRIANGLES - 1) / CHUNK_TRIANGLES);
+		std::iota(chunkIds.begin(), chunkIds.end(), 0u);
+
+		std::vector<uint32_t> vertexIds(vertexCount);
+		std::iota(vertexIds.begin(), vertexIds.end(), 0u);
+
+		// Which faces every vertex is outside of.
+		std::vector<uint8_t> outcodes(vertexCount);
+		std::for_each(std::execution::par, vertexIds.begin(), vertexIds.end(), [&](uint32_t i)
+		{
+			outcodes[i] = uint8_t(outcode(box, vertices[i].position));
+		});
+
+		// First pass: the triangles of every chunk, pointing at input vertices or at vertices new to the chunk.
+		std::vector<Chunk> chunks(chunkIds.size());
+		std::vector<uint32_t> used(vertexCount, 0);
+		std::for_each(std::execution::par, chunkIds.begin(), chunkIds.end(), [&](uint32_t chunkId)
+		{
+			Chunk& chunk = chunks[chunkId];
+			const uint32_t first = chunkId * CHUNK_TRIANGLES;
+			const uint32_t last = std::min(triangleCount, first + CHUNK_TRIANGLES);
+			chunk.indices.reserve(3 * size_t(last - first));
+
+			for (uint32_t t = first; t < last; t++)
+			{
+				const uint32_t* triangle = &indices[3 * size_t(t)];
+				const uint32_t codes[3] = { outcodes[triangle[0]], outcodes[triangle[1]], outcodes[triangle[2]] };
+				if (codes[0] & codes[1] & codes[2])
+					continue;
+
+				const uint32_t crossedFaces = codes[0] | codes[1] | codes[2];
+				if (crossedFaces == 0)
+					chunk.indices.insert(chunk.indices.end(), { triangle[0], triangle[1], triangle[2] });
+				else
+					clipTriangle(vertices, box, triangle, crossedFaces, chunk);
+			}
+
+			for (uint32_t index : chunk.indices)
+				if (!(index & NEW_VERTEX))
+					std::atomic_ref<uint32_t>(used[index]).store(1, std::memory_order_relaxed);
+		});
+
+		// Compaction: the used input vertices keep their order, every chunk appends its new vertices after them.
+		std::vector<uint32_t> remap(vertexCount);
+		std::exclusive_scan(std::execution::par, used.begin(), used.end(), remap.begin(), 0u);
+		const uint32_t keptCount = vertexCount == 0 ? 0 : remap.back() + used.back();
+
+		size_t indexCount = 0;
+		size_t newVertexCount = 0;
+		for (Chunk& chunk : chunks)
+		{
+			chunk.indexOffset = indexCount;
+			chunk.newVertexOffset = keptCount + newVertexCount;
+			indexCount += chunk.indices.size();
+			newVertexCount += chunk.newVertices.size();
+		}
+
+		resultVertices.resize(keptCount + newVertexCount);
+		resultIndices.resize(indexCount);
+
+		std::for_each(std::execution::par, vertexIds.begin(), vertexIds.end(), [&](uint32_t i)
+		{
+			if (used[i])
+				resultVertices[remap[i]] = vertices[i];
+		});
+
+		std::for_each(std::execution::par, chunkIds.begin(), chunkIds.end(), [&](uint32_t chunkId)
+		{
+			const Chunk& chunk = chunks[chunkId];
+			std::copy(chunk.newVertices.begin(), chunk.newVertices.end(), resultVertices.begin() + chunk.newVertexOffset);
+			for (size_t k = 0; k < chunk.indices.size(); k++)
+			{
+				const uint32_t index = chunk.indices[k];
+				resultIndices[chunk.indexOffset + k] = index & NEW_VERTEX
+					? uint32_t(chunk.newVertexOffset) + (index & ~NEW_VERTEX)
+					: remap[index];
+			}
+		});
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "SegmentClipper.h"
+#include "Vertex.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Sutherland-Hodgman clipping of an indexed triangle mesh (e.g. the vertices and indices of a Model::Builder)
+	// against an axis aligned box. Triangles are handled in parallel chunks: those inside stay as they are,
+	// those outside a single face are dropped, and the rest are cut by the faces they cross into a fan, with
+	// new vertices on the cut edges whose attributes are interpolated along the edge.
+	class MeshClipper
+	{
+	public:
+		using Box = SegmentClipper::Box;
+
+		// The result holds the vertices still in use, in their original order, followed by the new ones,
+		// and the triangles in input order. Triangles that only touch the box are dropped.
+		static void clip(
+			const std::vector<Vertex>& vertices,
+			const std::vector<uint32_t>& indices,
+			const Box& box,
+			std::vector<Vertex>& resultVertices,
+			std::vector<uint32_t>& resultIndices);
+	};
+}
@@ -29,6 +29,7 @@ namespace assignment
 		};
 
 		Model(Device& device, const Model::Builder& builder);
+		Model(Device& device, uint32_t vertexCount, VkBufferUsageFlags usage);
 		~Model();
 
 		NO_COPY(Model);
@@ -37,32 +38,9 @@ namespace assignment
 		static std::unique_ptr<Model> createModelFromFile(Device& device, const std::string& filepath);
 		static std::unique_ptr<Model> createModelFromVector(Device& device, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
 
+		// Indexes a rows x cols grid as it is; the vertices carry their own normals, e.g. from SurfaceMesh::calculateSplineSurface.
 		static std::unique_ptr<Model> createSmoothSurfaceFromVector(Device& device, const std::vector<Vertex>& vertices, uint32_t rows, uint32_t cols);
 		static std::unique_ptr<Model> createFlatSurfaceFromVector(Device& device, const std::vector<Vertex>& vertices, uint32_t rows, uint32_t cols);
-
-		static std::vector<Vertex> calculateSplineSurface(
-			int degreeU,
-			int degreeV,
-			std::vector<float>& knotsU,
-			std::vector<float>& knotsV,
-			std::vector<Vertex>& controlPoints,
-			uint32_t subdivisions = 10
-		);
-
-		static std::vector<float> calculateKnots(uint32_t degree, int size);
-
-	public:
-		static Vertex calculateSpline(
-			float u,
-			float v,
-			int degreeU,
-			int degreeV,
-			std::vector<float>& knotsU,
-			std::vector<float>& knotsV,
-			std::vector<Vertex>& controlPoints
-		);
-		static float basisFunction(int i, int p, float u, const std::vector<float>& knots);
-
 	};
 };
 
@@ -15,13 +15,43 @@ namespace assignment
 		const PipelineConfigInfo& configInfo)
 		: m_device(device)
 	{
-		createGraphicsPipeline(device, vertFilepath, fragFilepath, configInfo);
+		createGraphicsPipeline(
+			device,
+			{
+				{ VK_SHADER_STAGE_VERTEX_BIT, vertFilepath },
+				{ VK_SHADER_STAGE_FRAGMENT_BIT, fragFilepath }
+			},
+			configInfo);
+	}
+
+	Pipeline::Pipeline(
+		Device& device,
+		const std::string& vertFilepath,
+		const std::string& tescFilepath,
+		const std::string& teseFilepath,
+		const std::string& fragFilepath,
+		const PipelineConfigInfo& configInfo)
+		: m_device(device)
+	{
+		assert(
+			configInfo.tessellationInfo.patchControlPoints > 0 &&
+			"Cannot create tessellation pipeline: use tessellationPipelineConfigInfo");
+
+		createGraphicsPipeline(
+			device,
+			{
+				{ VK_SHADER_STAGE_VERTEX_BIT, vertFilepath },
+				{ VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT, tescFilepath },
+				{ VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT, teseFilepath },
+				{ VK_SHADER_STAGE_FRAGMENT_BIT, fragFilepath }
+			},
+			configInfo);
 	}
 
 	Pipeline::~Pipeline()
 	{
-		vkDestroyShaderModule(m_device.device(), vertShaderModule, nullptr);
-		vkDestroyShaderModule(m_device.device(), fragShaderModule, nullptr);
+		for (VkShaderModule shaderModule : shaderModules)
+			vkDestroyShaderModule(m_device.device(), shaderModule, nullptr);
 		vkDestroyPipeline(m_device.device(), graphicsPipeline, nullptr);
 	}
 
@@ -93,6 +123,19 @@ namespace assignment
 		configInfo.dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 		configInfo.dynamicStateInfo.dynamicStateCount = uint32_t(configInfo.dynamicStateEnables.size());
 		configInfo.dynamicStateInfo.pDynamicStates = configInfo.dynamicStateEnables.data();
+
+		configInfo.bindingDescriptions = GraphicsPrimitive::getBindingDescriptions();
+		configInfo.attributeDescriptions = GraphicsPrimitive::getAttributeDescriptions();
+	}
+
+	void Pipeline::tessellationPipelineConfigInfo(PipelineConfigInfo& configInfo, uint32_t patchControlPoints)
+	{
+		defaultPipelineConfigInfo(configInfo);
+
+		configInfo.inputAssemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+
+		configInfo.tessellationInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO;
+		configInfo.tessellationInfo.patchControlPoints = patchControlPoints;
 	}
 
 	std::vector<char> Pipeline::readFile(const std::string& filepath)
@@ -113,8 +156,7 @@ namespace assignment
 
 	void Pipeline::createGraphicsPipeline(
 		Device& device,
-		const std::string& vertFilepath,
-		const std::string& fragFilepath,
+		const std::vector<ShaderStageFile>& stageFiles,
 		const PipelineConfigInfo& configInfo)
 	{
 		assert(
@@ -124,32 +166,24 @@ namespace assignment
 			configInfo.renderPass != VK_NULL_HANDLE &&
 			"Cannot create graphics pipeline: no renderPass provided in configInfo");
 
-		auto vertCode = readFile(vertFilepath);
-		auto fragCode = readFile(fragFilepath);
-
-		createShaderModule(vertCode, &vertShaderModule);
-		createShaderModule(fragCode, &fragShaderModule);
-
-		VkPipelineShaderStageCreateInfo shaderStages[2];
-
-		shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-		shaderStages[0].module = vertShaderModule;
-		shaderStages[0].pName = "main";
-		shaderStages[0].flags = 0;
-		shaderStages[0].pNext = nullptr;
-		shaderStages[0].pSpecializationInfo = nullptr;
-
-		shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-		shaderStages[1].module = fragShaderModule;
-		shaderStages[1].pName = "main";
-		shaderStages[1].flags = 0;
-		shaderStages[1].pNext = nullptr;
-		shaderStages[1].pSpecializationInfo = nullptr;
-
-		auto bindingDescriptions = Model::Vertex::getBindingDescriptions();
-		auto attributeDescriptions = Model::Vertex::getAttributeDescriptions();
+		shaderModules.resize(stageFiles.size());
+		std::vector<VkPipelineShaderStageCreateInfo> shaderStages(stageFiles.size());
+		for (size_t i = 0; i < stageFiles.size(); i++)
+		{
+			auto code = readFile(stageFiles[i].filepath);
+			createShaderModule(code, &shaderModules[i]);
+
+			shaderStages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			shaderStages[i].stage = stageFiles[i].stage;
+			shaderStages[i].module = shaderModules[i];
+			shaderStages[i].pName = "main";
+			shaderStages[i].flags = 0;
+			shaderStages[i].pNext = nullptr;
+			shaderStages[i].pSpecializationInfo = nullptr;
+		}
+
+		const auto& bindingDescriptions = configInfo.bindingDescriptions;
+		const auto& attributeDescriptions = configInfo.attributeDescriptions;
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 		vertexInputInfo.vertexBindingDescriptionCount = uint32_t(bindingDescriptions.size());
@@ -160,10 +194,11 @@ namespace assignment
 
 		VkGraphicsPipelineCreateInfo pipelineInfo{};
 		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-		pipelineInfo.stageCount = 2;
-		pipelineInfo.pStages = shaderStages;
+		pipelineInfo.stageCount = uint32_t(shaderStages.size());
+		pipelineInfo.pStages = shaderStages.data();
 		pipelineInfo.pVertexInputState = &vertexInputInfo;
 		pipelineInfo.pInputAssemblyState = &configInfo.inputAssemblyInfo;
+		pipelineInfo.pTessellationState = configInfo.tessellationInfo.patchControlPoints > 0 ? &configInfo.tessellationInfo : nullptr;
 		pipelineInfo.pViewportState = &configInfo.viewportInfo;
 		pipelineInfo.pMultisampleState = &configInfo.multisampleInfo;
 		pipelineInfo.pDepthStencilState = &configInfo.depthStencilInfo;
@@ -13,8 +13,11 @@ namespace assignment
 		NO_COPY(PipelineConfigInfo);
 		PipelineConfigInfo() = default;
 
+		std::vector<VkVertexInputBindingDescription>	bindingDescriptions{};
+		std::vector<VkVertexInputAttributeDescription>	attributeDescriptions{};
 		VkPipelineViewportStateCreateInfo		viewportInfo;
 		VkPipelineInputAssemblyStateCreateInfo	inputAssemblyInfo;
+		VkPipelineTessellationStateCreateInfo	tessellationInfo{};
 		VkPipelineRasterizationStateCreateInfo	rasterizationInfo; 
 		VkPipelineMultisampleStateCreateInfo	multisampleInfo;
 		VkPipelineColorBlendAttachmentState		colorBlendAttachment;
@@ -37,21 +40,35 @@ namespace assignment
 			const std::string& vertFilepath,
 			const std::string& fragFilepath,
 			const PipelineConfigInfo& configInfo);
+		Pipeline(
+			Device& device,
+			const std::string& vertFilepath,
+			const std::string& tescFilepath,
+			const std::string& teseFilepath,
+			const std::string& fragFilepath,
+			const PipelineConfigInfo& configInfo);
 		~Pipeline();
 
 	public:
 		void bind(VkCommandBuffer commandBuffer);
 		static void defaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
+		// Patch list topology for pipelines with tessellation control and evaluation shaders.
+		static void tessellationPipelineConfigInfo(PipelineConfigInfo& configInfo, uint32_t patchControlPoints);
 
 		VkPipeline getPipeline() const { return graphicsPipeline; }
 
-	private:
 		static std::vector<char> readFile(const std::string& filepath);
 
+	private:
+		struct ShaderStageFile
+		{
+			VkShaderStageFlagBits stage;
+			std::string filepath;
+		};
+
 		void createGraphicsPipeline(
 			Device& device,
-			const std::string& vertFilepath,
-			const std::string& fragFilepath,
+			const std::vector<ShaderStageFile>& stageFiles,
 			const PipelineConfigInfo& configInfo);
 
 		void createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule);
@@ -59,7 +76,6 @@ namespace assignment
 	private:
 		Device& m_device;
 		VkPipeline graphicsPipeline;
-		VkShaderModule vertShaderModule;
-		VkShaderModule fragShaderModule;
+		std::vector<VkShaderModule> shaderModules;
 	};
 }
@@ -0,0 +1,70 @@
+#include "RandomSegments.h"
+
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+namespace assignment
+{
+	namespace
+	{
+		constexpr uint32_t CHUNK_SIZE = 16384;
+		// Numbers drawn per segment, one per coordinate.
+		constexpr uint64_t NUMBERS_PER_SEGMENT = 6;
+	}
+
+	void RandomSegments::generate(uint64_t seed, uint32_t count, const SegmentClipper::Box& bounds, SegmentClipper::Segments& segments)
+	{
+		segments.resize(count);
+
+		const uint64_t key = keyFromSeed(seed);
+		const glm::vec3 extent = bounds.max - bounds.min;
+		float* coordinates[NUMBERS_PER_SEGMENT] = {
+			segments.x0.data(), segments.y0.data(), segments.z0.data(),
+			segments.x1.data(), segments.y1.data(), segments.z1.data() };
+
+		std::vector<uint32_t> chunks((count + CHUNK_SIZE - 1) / CHUNK_SIZE);
+		std::iota(chunks.begin(), chunks.end(), 0u);
+		std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](uint32_t chunk)
+		{
+			const uint32_t first = chunk * CHUNK_SIZE;
+			const uint32_t last = std::min(count, first + CHUNK_SIZE);
+			// One coordinate array at a time keeps the iterations independent, so several hashes are in flight at once.
+			for (uint32_t k = 0; k < NUMBERS_PER_SEGMENT; k++)
+			{
+				const float offset = bounds.min[k % 3];
+				const float scale = extent[k % 3];
+				float* target = coordinates[k];
+				for (uint32_t i = first; i < last; i++)
+					target[i] = offset + toUnitFloat(squares32(NUMBERS_PER_SEGMENT * i + k, key)) * scale;
+			}
+		});
+	}
+
+	uint32_t RandomSegments::squares32(uint64_t counter, uint64_t key)
+	{
+		uint64_t x = counter * key;
+		const uint64_t y = x;
+		const uint64_t z = y + key;
+
+		// Three rounds of squaring with the halves swapped, the fourth keeps the upper half.
+		x = x * x + y;
+		x = (x >> 32) | (x << 32);
+		x = x * x + z;
+		x = (x >> 32) | (x << 32);
+		x = x * x + y;
+		x = (x >> 32) | (x << 32);
+		return uint32_t((x * x + z) >> 32);
+	}
+
+	uint64_t RandomSegments::keyFromSeed(uint64_t seed)
+	{
+		// splitmix64 finalizer; Squares wants an odd key with its bits spread over both halves.
+		uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		z ^= z >> 31;
+		return z | 1;
+	}
+}
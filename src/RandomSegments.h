@@ -0,0 +1,25 @@
+#pragma once
+
+#include "SegmentClipper.h"
+
+#include <cstdint>
+
+namespace assignment
+{
+	// Random line segments from a counter-based generator (Widynski's Squares): every number is a pure function
+	// of the seed and its position in the stream, so segments are generated in parallel, in any order, and
+	// the same seed always gives the same set.
+	class RandomSegments
+	{
+	public:
+		// Fills segments with count segments whose endpoints are uniform in bounds. Segment i depends only on seed and i.
+		static void generate(uint64_t seed, uint32_t count, const SegmentClipper::Box& bounds, SegmentClipper::Segments& segments);
+
+		// Number counter of the stream belonging to key.
+		static uint32_t squares32(uint64_t counter, uint64_t key);
+		// Spreads the bits of a seed into a key for squares32.
+		static uint64_t keyFromSeed(uint64_t seed);
+		// Uniform in [0, 1) from the top 24 bits.
+		static float toUnitFloat(uint32_t bits) { return float(bits >> 8) * (1.f / 16777216.f); }
+	};
+}
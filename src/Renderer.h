@@ -22,6 +22,7 @@ namespace assignment
 	public:
 		VkRenderPass getSwapChainRenderPass() const { return swapChain->getRenderPass(); }
 		float getAspectRatio() const { return swapChain->extentAspectRatio(); }
+		VkExtent2D getSwapChainExtent() const { return swapChain->getSwapChainExtent(); }
 		bool isFrameInProgress() const { return isFrameStarted; }
 
 		VkCommandBuffer getCurrentCommandBuffer() const {
@@ -0,0 +1,196 @@
+#include "SegmentClipper.h"
+
+#include "CurveBatchEvaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SEGMENT_CLIPPER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define SEGMENT_CLIPPER_AVX2_TARGET
+#else
+#define SEGMENT_CLIPPER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace assignment
+{
+	void SegmentClipper::Segments::resize(size_t count)
+	{
+		x0.resize(count);
+		y0.resize(count);
+		z0.resize(count);
+		x1.resize(count);
+		y1.resize(count);
+		z1.resize(count);
+	}
+
+	void SegmentClipper::clip(const Segments& segments, const Box& box, Segments& result, std::vector<uint32_t>& indices)
+	{
+		const uint32_t count = segments.size();
+		assert(segments.y0.size() == count && segments.z0.size() == count &&
+			segments.x1.size() == count && segments.y1.size() == count && segments.z1.size() == count &&
+			"Segment coordinate arrays differ in size");
+
+		// Shrinking back keeps the capacity, so clipping every frame does not allocate.
+		result.resize(size_t(count) + LANES);
+		indices.resize(size_t(count) + LANES);
+
+		static const bool useAvx2 = CurveBatchEvaluator::hasAvx2();
+		const uint32_t survivors = useAvx2
+			? clipAvx2(segments, box, result, indices.data())
+			: clipScalar(segments, box, 0, count, result, indices.data(), 0);
+
+		result.resize(survivors);
+		indices.resize(survivors);
+	}
+
+	uint32_t SegmentClipper::clipScalar(
+		const Segments& segments,
+		const Box& box,
+		uint32_t first,
+		uint32_t last,
+		Segments& result,
+		uint32_t* indices,
+		uint32_t survivors)
+	{
+		for (uint32_t i = first; i < last; i++)
+		{
+			const glm::vec3 p0(segments.x0[i], segments.y0[i], segments.z0[i]);
+			const glm::vec3 d = glm::vec3(segments.x1[i], segments.y1[i], segments.z1[i]) - p0;
+
+			// Entering and leaving parameter of every slab; a segment parallel to a slab is either inside it or gone.
+			float t0 = 0.f, t1 = 1.f;
+			bool outside = false;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (d[axis] == 0.f)
+				{
+					outside |= p0[axis] < box.min[axis] || p0[axis] > box.max[axis];
+					continue;
+				}
+
+				const float inverse = 1.f / d[axis];
+				const float a = (box.min[axis] - p0[axis]) * inverse;
+				const float b = (box.max[axis] - p0[axis]) * inverse;
+				t0 = std::max(t0, std::min(a, b));
+				t1 = std::min(t1, std::max(a, b));
+			}
+			if (outside || !(t0 < t1))
+				continue;
+
+			result.x0[survivors] = p0.x + t0 * d.x;
+			result.y0[survivors] = p0.y + t0 * d.y;
+			result.z0[survivors] = p0.z + t0 * d.z;
+			result.x1[survivors] = p0.x + t1 * d.x;
+			result.y1[survivors] = p0.y + t1 * d.y;
+			result.z1[survivors] = p0.z + t1 * d.z;
+			indices[survivors] = i;
+			survivors++;
+		}
+
+		return survivors;
+	}
+
+#ifdef SEGMENT_CLIPPER_X86
+	namespace
+	{
+		// Lane order that moves the set lanes of a mask to the front.
+		constexpr std::array<std::array<int32_t, 8>, 256> COMPRESS_PERMUTATIONS = []
+		{
+			std::array<std::array<int32_t, 8>, 256> table{};
+			for (int mask = 0; mask < 256; mask++)
+			{
+				int n = 0;
+				for (int lane = 0; lane < 8; lane++)
+					if (mask & (1 << lane))
+						table[mask][n++] = lane;
+			}
+			return table;
+		}();
+	}
+
+	SEGMENT_CLIPPER_AVX2_TARGET
+	uint32_t SegmentClipper::clipAvx2(const Segments& segments, const Box& box, Segments& result, uint32_t* indices)
+	{
+		const uint32_t count = segments.size();
+		const float* start[3] = { segments.x0.data(), segments.y0.data(), segments.z0.data() };
+		const float* end[3] = { segments.x1.data(), segments.y1.data(), segments.z1.data() };
+		float* resultStart[3] = { result.x0.data(), result.y0.data(), result.z0.data() };
+		float* resultEnd[3] = { result.x1.data(), result.y1.data(), result.z1.data() };
+
+		__m256 boxMin[3], boxMax[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			boxMin[axis] = _mm256_set1_ps(box.min[axis]);
+			boxMax[axis] = _mm256_set1_ps(box.max[axis]);
+		}
+
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.f);
+		const __m256 infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+		const __m256 negativeInfinity = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+		const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+		uint32_t survivors = 0;
+		const uint32_t batchEnd = count - count % LANES;
+		for (uint32_t i = 0; i < batchEnd; i += LANES)
+		{
+			__m256 p0[3], d[3];
+			__m256 t0 = zero, t1 = one;
+			__m256 outside = zero;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				p0[axis] = _mm256_loadu_ps(start[axis] + i);
+				d[axis] = _mm256_sub_ps(_mm256_loadu_ps(end[axis] + i), p0[axis]);
+
+				// Same slab test as clipScalar; parallel lanes divide by zero and are replaced afterwards.
+				const __m256 inverse = _mm256_div_ps(one, d[axis]);
+				const __m256 a = _mm256_mul_ps(_mm256_sub_ps(boxMin[axis], p0[axis]), inverse);
+				const __m256 b = _mm256_mul_ps(_mm256_sub_ps(boxMax[axis], p0[axis]), inverse);
+
+				const __m256 parallel = _mm256_cmp_ps(d[axis], zero, _CMP_EQ_OQ);
+				const __m256 enter = _mm256_blendv_ps(_mm256_min_ps(a, b), negativeInfinity, parallel);
+				const __m256 leave = _mm256_blendv_ps(_mm256_max_ps(a, b), infinity, parallel);
+				t0 = _mm256_max_ps(t0, enter);
+				t1 = _mm256_min_ps(t1, leave);
+
+				const __m256 outsideSlab = _mm256_or_ps(
+					_mm256_cmp_ps(p0[axis], boxMin[axis], _CMP_LT_OQ),
+					_mm256_cmp_ps(p0[axis], boxMax[axis], _CMP_GT_OQ));
+				outside = _mm256_or_ps(outside, _mm256_and_ps(parallel, outsideSlab));
+			}
+
+			const __m256 accepted = _mm256_andnot_ps(outside, _mm256_cmp_ps(t0, t1, _CMP_LT_OQ));
+			const int mask = _mm256_movemask_ps(accepted);
+			if (mask == 0)
+				continue;
+
+			const __m256i permutation = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(COMPRESS_PERMUTATIONS[mask].data()));
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const __m256 first = _mm256_add_ps(p0[axis], _mm256_mul_ps(t0, d[axis]));
+				const __m256 last = _mm256_add_ps(p0[axis], _mm256_mul_ps(t1, d[axis]));
+				_mm256_storeu_ps(resultStart[axis] + survivors, _mm256_permutevar8x32_ps(first, permutation));
+				_mm256_storeu_ps(resultEnd[axis] + survivors, _mm256_permutevar8x32_ps(last, permutation));
+			}
+			const __m256i index = _mm256_add_epi32(_mm256_set1_epi32(int(i)), laneIndex);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(indices + survivors), _mm256_permutevar8x32_epi32(index, permutation));
+
+			survivors += uint32_t(std::popcount(uint32_t(mask)));
+		}
+
+		return clipScalar(segments, box, batchEnd, count, result, indices, survivors);
+	}
+#else
+	uint32_t SegmentClipper::clipAvx2(const Segments& segments, const Box& box, Segments& result, uint32_t* indices)
+	{
+		return clipScalar(segments, box, 0, segments.size(), result, indices, 0);
+	}
+#endif
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Liang-Barsky clipping of many line segments against an axis aligned box.
+	// Segments are passed as separate coordinate arrays; on CPUs with AVX2 eight segments
+	// are clipped per iteration and the survivors are packed with a lane permutation,
+	// otherwise a scalar loop is used.
+	class SegmentClipper
+	{
+	public:
+		static constexpr uint32_t LANES = 8;
+
+		// Segment i runs from (x0[i], y0[i], z0[i]) to (x1[i], y1[i], z1[i]).
+		struct Segments
+		{
+			std::vector<float> x0{};
+			std::vector<float> y0{};
+			std::vector<float> z0{};
+			std::vector<float> x1{};
+			std::vector<float> y1{};
+			std::vector<float> z1{};
+
+			uint32_t size() const { return uint32_t(x0.size()); }
+			void resize(size_t count);
+		};
+
+		struct Box
+		{
+			glm::vec3 min{ 0.f };
+			glm::vec3 max{ 1.f };
+		};
+
+	public:
+		// result receives the parts of the segments inside the box, packed in input order, and
+		// indices the segment each of them came from. Segments that only touch the box are dropped.
+		static void clip(const Segments& segments, const Box& box, Segments& result, std::vector<uint32_t>& indices);
+
+		// Clips segments [first, last) and writes the survivors from result[survivors] on; returns the new survivor count.
+		static uint32_t clipScalar(
+			const Segments& segments,
+			const Box& box,
+			uint32_t first,
+			uint32_t last,
+			Segments& result,
+			uint32_t* indices,
+			uint32_t survivors);
+
+	private:
+		// Stores whole vectors, so result and indices need LANES elements of room past the last survivor.
+		static uint32_t clipAvx2(const Segments& segments, const Box& box, Segments& result, uint32_t* indices);
+	};
+}
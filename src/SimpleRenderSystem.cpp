@@ -55,11 +55,19 @@ namespace assignment
 			"shaders/vert.spv",
 			"shaders/frag.spv",
 			pipelineConfig);
+
+		if (device.getEnabledFeatures().shaderClipDistance)
+			clippedPipeline = std::make_unique<Pipeline>(
+				device,
+				"shaders/clippedVert.spv",
+				"shaders/frag.spv",
+				pipelineConfig);
 	}
 
 	void SimpleRenderSystem::renderGameObjects(FrameInfo& frameInfo, std::vector<GameObject>& gameObjects)
 	{
-		pipeline->bind(frameInfo.commandBuffer);
+		Pipeline* boundPipeline = pipeline.get();
+		boundPipeline->bind(frameInfo.commandBuffer);
 
 		vkCmdBindDescriptorSets(
 			frameInfo.commandBuffer,
@@ -73,6 +81,14 @@ namespace assignment
 		{
 			if (!obj.visible)
 				continue;
+
+			Pipeline* objectPipeline = obj.clipped && clippedPipeline ? clippedPipeline.get() : pipeline.get();
+			if (objectPipeline != boundPipeline)
+			{
+				boundPipeline = objectPipeline;
+				boundPipeline->bind(frameInfo.commandBuffer);
+			}
+
 			SimplePushConstantData push{};
 			push.modelMatrix = obj.transform.mat4();
 			push.normalMatrix = obj.transform.normalMatrix();
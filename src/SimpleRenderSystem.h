@@ -31,6 +31,8 @@ namespace assignment
 		Device& device;
 
 		std::unique_ptr<Pipeline> pipeline;
+		// For GameObject::clipped; only created when the device has shaderClipDistance.
+		std::unique_ptr<Pipeline> clippedPipeline;
 		VkPipelineLayout pipelineLayout;
 
 	};
@@ -0,0 +1,327 @@
+#include "SplineCurves.h"
+
+#include "ArcLengthTable.h"
+#include "BezierExtraction.h"
+#include "CurveBatchEvaluator.h"
+#include "SplineKernels.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace assignment
+{
+	void SplineCurves::calculateTs(const std::vector<Vertex>& vertices, std::vector<float>& t)
+	{
+		for (int i = 0; i < vertices.size() - 1; i++)
+			t.push_back(glm::distance(vertices[i + 1].position, vertices[i].position));
+	}
+
+	std::vector<float> SplineCurves::evenlySpacedTaus(uint32_t n)
+	{
+		std::vector<float> taus;
+		for (uint32_t i = 0; i < n; i++)
+			taus.push_back(float(i + 1) / float(n+1));
+		return taus;
+	}
+
+	std::vector<Vertex> SplineCurves::calculateCubicSpline(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn, const std::vector<float>& taus)
+	{
+		std::vector<float> t = { 1.f };
+		t.reserve(vertices.size());
+		calculateTs(vertices, t);
+
+		std::vector<glm::vec3> tangents = tangentRightHandSide(vertices, t, P1, Pn);
+		solveTangents(t, tangents);
+
+		const std::vector<glm::vec4> weights = hermiteWeights(taus);
+		const size_t segmentSize = taus.size() + 1;
+		const size_t segmentCount = vertices.size() - 1;
+
+		std::vector<Vertex> newVertexArray(segmentCount * segmentSize + 1);
+		for (size_t i = 0; i < segmentCount; i++)
+		{
+			const glm::vec3 p0 = vertices[i].position;
+			const glm::vec3 p1 = vertices[i + 1].position;
+			const glm::vec3 m0 = tangents[i] * t[i + 1];
+			const glm::vec3 m1 = tangents[i + 1] * t[i + 1];
+			const glm::vec3 color = (vertices[i + 1].color + vertices[i].color) / 2.f;
+
+			Vertex* segment = &newVertexArray[i * segmentSize];
+			segment[0].position = p0;
+			segment[0].color = vertices[i].color;
+			for (size_t j = 0; j < weights.size(); j++)
+			{
+				const glm::vec4& w = weights[j];
+				segment[j + 1].position = w.x * p0 + w.y * p1 + w.z * m0 + w.w * m1;
+				segment[j + 1].color = color;
+			}
+		}
+		newVertexArray.back().position = vertices.back().position;
+		newVertexArray.back().color = vertices.back().color;
+
+		return newVertexArray;
+	}
+
+	std::vector<Vertex> SplineCurves::adaptiveCubicSpline(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn, const CurveFlattener::Tolerance& tolerance)
+	{
+		std::vector<float> params;
+		std::vector<glm::vec3> points;
+		CurveFlattener::flatten(cubicSplineCurve(vertices, P1, Pn), cubicSplineBreakpoints(vertices), tolerance, params, points);
+		return cubicSplineVertices(vertices, params, points);
+	}
+
+	std::vector<Vertex> SplineCurves::arcLengthCubicSpline(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn, uint32_t count)
+	{
+		const CurveFlattener::Curve curve = cubicSplineCurve(vertices, P1, Pn);
+		const ArcLengthTable table(curve, cubicSplineBreakpoints(vertices));
+
+		const std::vector<float> params = table.evenlySpacedParameters(count);
+		std::vector<glm::vec3> points(params.size());
+		for (size_t k = 0; k < params.size(); k++)
+			points[k] = curve(params[k]);
+
+		return cubicSplineVertices(vertices, params, points);
+	}
+
+	CurveFlattener::Curve SplineCurves::cubicSplineCurve(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn)
+	{
+		std::vector<float> t = { 1.f };
+		t.reserve(vertices.size());
+		calculateTs(vertices, t);
+
+		std::vector<glm::vec3> tangents = tangentRightHandSide(vertices, t, P1, Pn);
+		solveTangents(t, tangents);
+
+		std::vector<glm::vec3> positions(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+			positions[i] = vertices[i].position;
+
+		// Segment i covers the parameters [i, i + 1].
+		return [positions = std::move(positions), tangents = std::move(tangents), t = std::move(t)](float s)
+		{
+			const size_t i = std::min(size_t(s), positions.size() - 2);
+			const glm::vec4 w = hermiteWeight(s - float(i));
+			return w.x * positions[i] + w.y * positions[i + 1] +
+				(w.z * tangents[i] + w.w * tangents[i + 1]) * t[i + 1];
+		};
+	}
+
+	std::vector<float> SplineCurves::cubicSplineBreakpoints(const std::vector<Vertex>& vertices)
+	{
+		std::vector<float> breakpoints(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+			breakpoints[i] = float(i);
+		return breakpoints;
+	}
+
+	std::vector<Vertex> SplineCurves::cubicSplineVertices(const std::vector<Vertex>& vertices, const std::vector<float>& params, const std::vector<glm::vec3>& points)
+	{
+		const size_t segmentCount = vertices.size() - 1;
+
+		std::vector<Vertex> newVertexArray(points.size());
+		for (size_t k = 0; k < points.size(); k++)
+		{
+			const size_t i = std::min(size_t(params[k]), segmentCount);
+			newVertexArray[k].position = points[k];
+			newVertexArray[k].color = params[k] == float(i)
+				? vertices[i].color
+				: (vertices[i + 1].color + vertices[i].color) / 2.f;
+		}
+
+		return newVertexArray;
+	}
+
+	glm::vec4 SplineCurves::hermiteWeight(float tau)
+	{
+		// Hermite basis h00, h01, h10, h11; the tangent terms are scaled by the segment length per segment.
+		const float tau2 = tau * tau;
+		const float tau3 = tau2 * tau;
+		return {
+			2 * tau3 - 3 * tau2 + 1,
+			-2 * tau3 + 3 * tau2,
+			tau3 - 2 * tau2 + tau,
+			tau3 - tau2 };
+	}
+
+	std::vector<glm::vec4> SplineCurves::hermiteWeights(const std::vector<float>& taus)
+	{
+		std::vector<glm::vec4> weights;
+		weights.reserve(taus.size());
+		for (float tau : taus)
+			weights.push_back(hermiteWeight(tau));
+		return weights;
+	}
+
+	std::vector<glm::vec3> SplineCurves::tangentRightHandSide(const std::vector<Vertex>& vertices, const std::vector<float>& t, glm::vec3 P1, glm::vec3 Pn)
+	{
+		const size_t n = vertices.size();
+		std::vector<glm::vec3> vectors(n);
+
+		vectors[0] = P1;
+		for (size_t i = 1; i < n - 1; i++)
+		{
+			vectors[i] = (3.f / (t[i] * t[i + 1])) *
+				(t[i] * t[i] * (vertices[i + 1].position - vertices[i].position) +
+				 t[i + 1] * t[i + 1] * (vertices[i].position - vertices[i - 1].position));
+		}
+		vectors[n - 1] = Pn;
+
+		return vectors;
+	}
+
+	void SplineCurves::solveTangents(const std::vector<float>& t, std::vector<glm::vec3>& tangents)
+	{
+		// Thomas algorithm for the tridiagonal tangent system: the first and last rows
+		// are identity (given end tangents), row i is t[i+1], 2 * (t[i] + t[i+1]), t[i].
+		// It is diagonally dominant, so no pivoting is needed.
+		const size_t n = tangents.size();
+
+		std::vector<float> upper(n);
+
+		upper[0] = 0.f;
+		for (size_t i = 1; i < n; i++)
+		{
+			const bool inner = i < n - 1;
+			const float lower = inner ? t[i + 1] : 0.f;
+			const float diagonal = inner ? 2 * (t[i] + t[i + 1]) : 1.f;
+			const float super = inner ? t[i] : 0.f;
+
+			const float m = 1.f / (diagonal - lower * upper[i - 1]);
+			upper[i] = super * m;
+			tangents[i] = (tangents[i] - lower * tangents[i - 1]) * m;
+		}
+
+		for (size_t i = n - 1; i-- > 0;)
+			tangents[i] -= upper[i] * tangents[i + 1];
+	}
+
+	std::vector<float> SplineCurves::openedKnots(uint32_t count, uint32_t degree)
+	{
+		std::vector<float> ts;
+		for (uint32_t i = 1; i <= degree; i++)
+			ts.push_back(0.f);
+		for (uint32_t i = degree + 1; i <= count; i++)
+			ts.push_back(i - degree);
+		for (uint32_t i = count + 1; i <= count + degree; i++)
+			ts.push_back(count - degree + 1);
+		return ts;
+	}
+
+	std::vector<float> SplineCurves::evenlySpacedKnots(uint32_t count, uint32_t degree)
+	{
+		std::vector<float> ts;
+		for (uint32_t i = 0; i < count + degree + 1; i++)
+			ts.push_back(static_cast<float>(i));
+		return ts;
+	}
+
+	std::vector<Vertex> SplineCurves::calculateBSpline(const std::vector<Vertex>& vertices, uint32_t degree, const std::vector<float>& ts, uint32_t subdivisions)
+	{
+		const uint32_t count = uint32_t(vertices.size());
+		const float start = ts[degree];
+		const float end = ts[count];
+
+		std::vector<float> params(subdivisions + 1);
+		for (uint32_t i = 0; i <= subdivisions; i++)
+			params[i] = start + (end - start) * float(i) / float(subdivisions);
+
+		std::vector<Vertex> newVertexVector(params.size());
+		for (auto& v : newVertexVector)
+			v.color = vertices[0].color;
+
+		// Curves in the z = 0 plane only need two coordinates. The AVX2 gather path is still
+		// faster than the specialized kernels for 3D curves, so those only replace the scalar loop.
+		const bool planar = std::all_of(vertices.begin(), vertices.end(), [](const Vertex& v) { return v.position.z == 0.f; });
+		const uint32_t dimension = planar ? 2 : 3;
+		const SplineKernels::CurveKernel kernel = SplineKernels::curveKernel(degree, dimension);
+		if (kernel != nullptr && (planar || !CurveBatchEvaluator::hasAvx2()))
+		{
+			std::vector<float> controlPoints;
+			controlPoints.reserve(size_t(count) * dimension);
+			for (const auto& v : vertices)
+				controlPoints.insert(controlPoints.end(), &v.position.x, &v.position.x + dimension);
+
+			std::vector<float> points(params.size() * dimension);
+			kernel(controlPoints.data(), count, ts, params.data(), uint32_t(params.size()), points.data());
+
+			for (size_t i = 0; i < newVertexVector.size(); i++)
+				for (uint32_t k = 0; k < dimension; k++)
+					newVertexVector[i].position[k] = points[i * dimension + k];
+			return newVertexVector;
+		}
+
+		CurveBatchEvaluator::ControlPolygon controlPolygon;
+		controlPolygon.x.reserve(count);
+		controlPolygon.y.reserve(count);
+		controlPolygon.z.reserve(count);
+		for (const auto& v : vertices)
+		{
+			controlPolygon.x.push_back(v.position.x);
+			controlPolygon.y.push_back(v.position.y);
+			controlPolygon.z.push_back(v.position.z);
+		}
+
+		CurveBatchEvaluator::Points points;
+		CurveBatchEvaluator::evaluate(controlPolygon, degree, ts, params, points);
+
+		for (uint32_t i = 0; i < newVertexVector.size(); i++)
+			newVertexVector[i].position = { points.x[i], points.y[i], points.z[i] };
+
+		return newVertexVector;
+	}
+
+	std::vector<Vertex> SplineCurves::adaptiveBSpline(const std::vector<Vertex>& vertices, uint32_t degree, const std::vector<float>& ts, const CurveFlattener::Tolerance& tolerance)
+	{
+		assert(degree <= BezierExtraction::MAX_DEGREE && "B-spline degree is too high");
+
+		const uint32_t count = uint32_t(vertices.size());
+		std::vector<glm::vec3> controlPoints(count);
+		for (uint32_t i = 0; i < count; i++)
+			controlPoints[i] = vertices[i].position;
+
+		// The flattener samples at arbitrary parameters, so the knot search and basis
+		// evaluation are paid once per segment instead of once per sample.
+		const std::vector<float> knots(ts.begin(), ts.begin() + count + degree + 1);
+		const BezierExtraction::Curve bezier = BezierExtraction::extractCurve(degree, knots, controlPoints);
+		auto curve = [&](float u) { return bezier.evaluate(u); };
+
+		// The curve is only C^(degree - 1) at the knots, so they are always kept.
+		std::vector<float> params;
+		std::vector<glm::vec3> points;
+		CurveFlattener::flatten(curve, bezier.breakpoints, tolerance, params, points);
+
+		std::vector<Vertex> newVertexVector(points.size());
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			newVertexVector[i].position = points[i];
+			newVertexVector[i].color = vertices[0].color;
+		}
+
+		return newVertexVector;
+	}
+
+	std::vector<Vertex> SplineCurves::arcLengthBSpline(const std::vector<Vertex>& vertices, uint32_t degree, const std::vector<float>& ts, uint32_t count)
+	{
+		assert(degree <= BezierExtraction::MAX_DEGREE && "B-spline degree is too high");
+
+		const uint32_t controlCount = uint32_t(vertices.size());
+		std::vector<glm::vec3> controlPoints(controlCount);
+		for (uint32_t i = 0; i < controlCount; i++)
+			controlPoints[i] = vertices[i].position;
+
+		const std::vector<float> knots(ts.begin(), ts.begin() + controlCount + degree + 1);
+		const BezierExtraction::Curve bezier = BezierExtraction::extractCurve(degree, knots, controlPoints);
+		const ArcLengthTable table([&](float u) { return bezier.evaluate(u); }, bezier.breakpoints);
+
+		const std::vector<float> params = table.evenlySpacedParameters(count);
+		std::vector<Vertex> newVertexVector(params.size());
+		for (size_t i = 0; i < params.size(); i++)
+		{
+			newVertexVector[i].position = bezier.evaluate(params[i]);
+			newVertexVector[i].color = vertices[0].color;
+		}
+
+		return newVertexVector;
+	}
+
+}
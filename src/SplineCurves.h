@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CurveFlattener.h"
+#include "Vertex.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// CPU side of the Line builders: everything up to the vertex and index lists, without Vulkan.
+	// calculateBSpline and adaptiveBSpline take the polynomial degree, the knot helpers take the order
+	// (degree + 1) like the Line builders do.
+	class SplineCurves
+	{
+	public:
+		// n parameters strictly inside (0, 1), one step apart.
+		static std::vector<float> evenlySpacedTaus(uint32_t n);
+		static std::vector<Vertex> calculateCubicSpline(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn, const std::vector<float>& taus);
+		static std::vector<Vertex> adaptiveCubicSpline(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn, const CurveFlattener::Tolerance& tolerance);
+		// count points a constant distance apart along the curve, see ArcLengthTable.
+		static std::vector<Vertex> arcLengthCubicSpline(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn, uint32_t count);
+
+		static std::vector<float> openedKnots(uint32_t count, uint32_t degree);
+		static std::vector<float> evenlySpacedKnots(uint32_t count, uint32_t degree);
+		static std::vector<Vertex> calculateBSpline(const std::vector<Vertex>& vertices, uint32_t degree, const std::vector<float>& ts, uint32_t subdivisions);
+		static std::vector<Vertex> adaptiveBSpline(const std::vector<Vertex>& vertices, uint32_t degree, const std::vector<float>& ts, const CurveFlattener::Tolerance& tolerance);
+		static std::vector<Vertex> arcLengthBSpline(const std::vector<Vertex>& vertices, uint32_t degree, const std::vector<float>& ts, uint32_t count);
+
+	private:
+		static void calculateTs(const std::vector<Vertex>& vertices, std::vector<float>& t);
+		// The interpolating cubic spline with segment i on the parameters [i, i + 1].
+		static CurveFlattener::Curve cubicSplineCurve(const std::vector<Vertex>& vertices, glm::vec3 P1, glm::vec3 Pn);
+		static std::vector<float> cubicSplineBreakpoints(const std::vector<Vertex>& vertices);
+		// Colors the sampled points like the evenly spaced spline: ends of a segment keep their vertex color, the inside gets the average.
+		static std::vector<Vertex> cubicSplineVertices(const std::vector<Vertex>& vertices, const std::vector<float>& params, const std::vector<glm::vec3>& points);
+		static glm::vec4 hermiteWeight(float tau);
+		static std::vector<glm::vec4> hermiteWeights(const std::vector<float>& taus);
+		static std::vector<glm::vec3> tangentRightHandSide(const std::vector<Vertex>& vertices, const std::vector<float>& t, glm::vec3 P1, glm::vec3 Pn);
+		static void solveTangents(const std::vector<float>& t, std::vector<glm::vec3>& tangents);
+	};
+}
@@ -0,0 +1,16 @@
+#include "SplineKernels.h"
+
+namespace assignment
+{
+	SplineKernels::CurveKernel SplineKernels::curveKernel(uint32_t degree, uint32_t dimension)
+	{
+		static const CurveKernel kernels[2][MAX_DEGREE] = {
+			{ evaluateCurve<1, 2>, evaluateCurve<2, 2>, evaluateCurve<3, 2>, evaluateCurve<4, 2>, evaluateCurve<5, 2> },
+			{ evaluateCurve<1, 3>, evaluateCurve<2, 3>, evaluateCurve<3, 3>, evaluateCurve<4, 3>, evaluateCurve<5, 3> },
+		};
+
+		if (degree < 1 || degree > MAX_DEGREE || dimension < 2 || dimension > 3)
+			return nullptr;
+		return kernels[dimension - 2][degree - 1];
+	}
+}
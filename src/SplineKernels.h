@@ -0,0 +1,108 @@
+#pragma once
+
+#include "BSplineBasis.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Degree and dimension specialized B-spline curve evaluation. Samples are handled in blocks of LANES
+	// with the basis stored lane by lane, so with every loop bound a compile time constant the compiler
+	// unrolls the recurrence and vectorizes it across the block. Degrees 1 to MAX_DEGREE in 2D and 3D
+	// cover every curve the application builds; anything else goes through the generic evaluators.
+	class SplineKernels
+	{
+	public:
+		static constexpr uint32_t MAX_DEGREE = 5;
+		static constexpr uint32_t LANES = 8;
+
+		// points holds count control points of dimension interleaved floats, result receives paramCount points the same way.
+		using CurveKernel = void (*)(
+			const float* points,
+			uint32_t count,
+			const std::vector<float>& knots,
+			const float* params,
+			uint32_t paramCount,
+			float* result);
+
+	public:
+		// Instantiation for the degree and dimension, nullptr if there is none.
+		static CurveKernel curveKernel(uint32_t degree, uint32_t dimension);
+
+		template<int Degree, int Dim>
+		static void evaluateCurve(
+			const float* points,
+			uint32_t count,
+			const std::vector<float>& knots,
+			const float* params,
+			uint32_t paramCount,
+			float* result)
+		{
+			static_assert(Degree >= 1 && Degree <= int(MAX_DEGREE), "Unsupported degree");
+
+			const float* knotData = knots.data();
+			uint32_t span = Degree;
+			for (uint32_t i = 0; i < paramCount; i += LANES)
+			{
+				// A short last block repeats its last sample in the unused lanes.
+				const uint32_t lanes = std::min(LANES, paramCount - i);
+
+				float u[LANES];
+				uint32_t spans[LANES];
+				float left[Degree + 1][LANES];
+				float right[Degree + 1][LANES];
+				for (uint32_t l = 0; l < LANES; l++)
+				{
+					u[l] = params[i + std::min(l, lanes - 1)];
+
+					// Samples usually come in increasing order, so the previous span is tried first.
+					if (u[l] < knotData[span] || u[l] >= knotData[span + 1])
+						span = BSplineBasis::findSpan(Degree, u[l], knots, count);
+					spans[l] = span;
+
+					for (int j = 1; j <= Degree; j++)
+					{
+						left[j][l] = u[l] - knotData[span + 1 - j];
+						right[j][l] = knotData[span + j] - u[l];
+					}
+				}
+
+				// BSplineBasis::evaluate without the zero check: findSpan only returns spans of
+				// non-zero length, and every denominator here contains that span.
+				float N[Degree + 1][LANES];
+				for (uint32_t l = 0; l < LANES; l++)
+					N[0][l] = 1.f;
+				for (int j = 1; j <= Degree; j++)
+				{
+					float saved[LANES] = {};
+					for (int r = 0; r < j; r++)
+					{
+						for (uint32_t l = 0; l < LANES; l++)
+						{
+							const float temp = N[r][l] / (right[r + 1][l] + left[j - r][l]);
+							N[r][l] = saved[l] + right[r + 1][l] * temp;
+							saved[l] = left[j - r][l] * temp;
+						}
+					}
+					for (uint32_t l = 0; l < LANES; l++)
+						N[j][l] = saved[l];
+				}
+
+				for (uint32_t l = 0; l < lanes; l++)
+				{
+					const float* controlPoints = points + size_t(spans[l] - Degree) * Dim;
+					float sum[Dim] = {};
+					for (int k = 0; k <= Degree; k++)
+						for (int d = 0; d < Dim; d++)
+							sum[d] += N[k][l] * controlPoints[k * Dim + d];
+
+					for (int d = 0; d < Dim; d++)
+						result[size_t(i + l) * Dim + d] = sum[d];
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,373 @@
+#include "SplineSurfaceComputeSystem.h"
+
+#include "SurfaceMesh.h"
+#include "SwapChain.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace assignment
+{
+	struct SplineSurfacePushConstantData
+	{
+		glm::vec4 color{ 1.f };
+		uint32_t rows;
+		uint32_t cols;
+		uint32_t degreeU;
+		uint32_t degreeV;
+		uint32_t subdivisions;
+		uint32_t knotOffsetV;
+		uint32_t rowBegin;
+		uint32_t rowEnd;
+		uint32_t columnBegin;
+		uint32_t columnEnd;
+	};
+
+	namespace
+	{
+		// Matches local_size_x/y of the compute shaders.
+		constexpr uint32_t WORKGROUP_SIZE = 16;
+
+		uint32_t groupCount(uint32_t invocations)
+		{
+			return (invocations + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+		}
+
+		SurfaceEvaluationPlan::SampleRegion merge(const SurfaceEvaluationPlan::SampleRegion& a, const SurfaceEvaluationPlan::SampleRegion& b)
+		{
+			if (a.empty())
+				return b;
+			if (b.empty())
+				return a;
+			return {
+				std::min(a.rowBegin, b.rowBegin), std::max(a.rowEnd, b.rowEnd),
+				std::min(a.columnBegin, b.columnBegin), std::max(a.columnEnd, b.columnEnd) };
+		}
+	}
+
+	SplineSurfaceComputeSystem::SplineSurfaceComputeSystem(
+		Device& device,
+		DeferredReleaseQueue& releaseQueue,
+		uint32_t rows,
+		uint32_t cols,
+		uint32_t degreeU,
+		uint32_t degreeV,
+		uint32_t subdivisions)
+		: device(device), releaseQueue(releaseQueue), rows(rows), cols(cols)
+	{
+		createDescriptorSetLayout();
+		createPipelineLayout();
+		createPipelines();
+		createControlPointBuffers();
+		setParameters(degreeU, degreeV, subdivisions);
+	}
+
+	SplineSurfaceComputeSystem::~SplineSurfaceComputeSystem()
+	{
+		vkDestroyPipelineLayout(device.device(), pipelineLayout, nullptr);
+	}
+
+	void SplineSurfaceComputeSystem::createDescriptorSetLayout()
+	{
+		setLayout = DescriptorSetLayout::Builder(device)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.build();
+
+		descriptorPool = DescriptorPool::Builder(device)
+			.setMaxSets(SwapChain::MAX_FRAMES_IN_FLIGHT)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * SwapChain::MAX_FRAMES_IN_FLIGHT)
+			.build();
+
+		descriptorSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+		for (auto& set : descriptorSets)
+			if (!descriptorPool->allocateDescriptor(setLayout->getDescriptorSetLayout(), set))
+				throw std::runtime_error("Failed to allocate spline surface descriptor set");
+	}
+
+	void SplineSurfaceComputeSystem::createPipelineLayout()
+	{
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(SplineSurfacePushConstantData);
+
+		VkDescriptorSetLayout descriptorSetLayout = setLayout->getDescriptorSetLayout();
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(device.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create pipeline layout");
+	}
+
+	void SplineSurfaceComputeSystem::createPipelines()
+	{
+		evaluatePipeline = std::make_unique<ComputePipeline>(device, "shaders/splineSurfaceComp.spv", pipelineLayout);
+		flatPipeline = std::make_unique<ComputePipeline>(device, "shaders/splineSurfaceFlatComp.spv", pipelineLayout);
+	}
+
+	void SplineSurfaceComputeSystem::createControlPointBuffers()
+	{
+		controlPointBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+		for (auto& buffer : controlPointBuffers)
+		{
+			buffer = std::make_unique<Buffer>(
+				device,
+				sizeof(glm::vec4),
+				rows * cols,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			buffer->map();
+		}
+	}
+
+	void SplineSurfaceComputeSystem::setParameters(uint32_t degreeU, uint32_t degreeV, uint32_t subdivisions)
+	{
+		assert(degreeU < rows && degreeV < cols && "Not enough control points for the degree");
+		assert(degreeU <= MAX_DEGREE && degreeV <= MAX_DEGREE && "B-spline degree is too high for the compute shader");
+		assert(subdivisions >= 2 && "Spline surface needs at least 2 subdivisions");
+
+		this->degreeU = degreeU;
+		this->degreeV = degreeV;
+		this->subdivisions = subdivisions;
+
+		releaseQueue.retire(std::move(knotBuffer));
+		releaseQueue.retire(std::move(sampleBuffer));
+		releaseQueue.retire(std::move(model));
+		createSurfaceBuffers();
+		descriptorSetsCurrent.assign(descriptorSets.size(), false);
+
+		// The new buffers hold nothing yet, so the next dispatch evaluates everything.
+		controlPositions.clear();
+	}
+
+	void SplineSurfaceComputeSystem::createSurfaceBuffers()
+	{
+		std::vector<float> knots = SurfaceMesh::calculateKnots(degreeU, rows);
+		const std::vector<float> knotsV = SurfaceMesh::calculateKnots(degreeV, cols);
+		plan = std::make_unique<SurfaceEvaluationPlan>(degreeU, degreeV, knots, knotsV, subdivisions);
+		knots.insert(knots.end(), knotsV.begin(), knotsV.end());
+
+		knotBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(float),
+			uint32_t(knots.size()),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		knotBuffer->map();
+		knotBuffer->writeToBuffer(knots.data());
+		knotBuffer->unmap();
+
+		sampleBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(glm::vec4),
+			subdivisions * subdivisions,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		model = std::make_shared<Model>(
+			device,
+			(subdivisions - 1) * (subdivisions - 1) * 6,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+	}
+
+	void SplineSurfaceComputeSystem::writeDescriptorSet(int frameIndex)
+	{
+		auto controlPointInfo = controlPointBuffers[frameIndex]->descriptorInfo();
+		auto knotInfo = knotBuffer->descriptorInfo();
+		auto sampleInfo = sampleBuffer->descriptorInfo();
+		auto vertexInfo = model->getVertexBuffer().descriptorInfo();
+
+		DescriptorWriter(*setLayout, *descriptorPool)
+			.writeBuffer(0, &controlPointInfo)
+			.writeBuffer(1, &knotInfo)
+			.writeBuffer(2, &sampleInfo)
+			.writeBuffer(3, &vertexInfo)
+			.overwrite(descriptorSets[frameIndex]);
+		descriptorSetsCurrent[frameIndex] = true;
+	}
+
+	void SplineSurfaceComputeSystem::updateControlPoints(int frameIndex, const std::vector<Vertex>& controlPoints)
+	{
+		assert(controlPoints.size() == size_t(rows) * cols && "Control net size does not match the surface");
+
+		std::vector<glm::vec4> positions(controlPoints.size());
+		for (size_t i = 0; i < controlPoints.size(); i++)
+			positions[i] = glm::vec4(controlPoints[i].position, 1.f);
+
+		// The whole net is written, since every frame has its own buffer; the region only limits the dispatch.
+		controlPointBuffers[frameIndex]->writeToBuffer(positions.data());
+
+		if (controlPositions.empty() || controlPoints[0].color != color)
+		{
+			pendingRegion = { 0, subdivisions, 0, subdivisions };
+		}
+		else
+		{
+			std::vector<uint32_t> changedControlPoints;
+			for (uint32_t i = 0; i < uint32_t(positions.size()); i++)
+				if (positions[i] != controlPositions[i])
+					changedControlPoints.push_back(i);
+			pendingRegion = merge(pendingRegion, plan->affectedRegion(changedControlPoints));
+		}
+
+		controlPositions = std::move(positions);
+		color = controlPoints[0].color;
+	}
+
+	void SplineSurfaceComputeSystem::dispatch(VkCommandBuffer commandBuffer, int frameIndex)
+	{
+		if (pendingRegion.empty())
+			return;
+		if (!descriptorSetsCurrent[frameIndex])
+			writeDescriptorSet(frameIndex);
+
+		const SurfaceEvaluationPlan::SampleRegion samples = pendingRegion;
+		pendingRegion = {};
+
+		SplineSurfacePushConstantData push{};
+		push.color = glm::vec4(color, 1.f);
+		push.rows = rows;
+		push.cols = cols;
+		push.degreeU = degreeU;
+		push.degreeV = degreeV;
+		push.subdivisions = subdivisions;
+		push.knotOffsetV = rows + degreeU + 1;
+		push.rowBegin = samples.rowBegin;
+		push.rowEnd = samples.rowEnd;
+		push.columnBegin = samples.columnBegin;
+		push.columnEnd = samples.columnEnd;
+
+		// The previous frame may still be drawing from the vertex buffer or reading the samples, and its
+		// dispatch wrote the samples and vertices that this one overwrites or, outside the region, reads.
+		VkMemoryBarrier previousDispatch{};
+		previousDispatch.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		previousDispatch.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		previousDispatch.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0,
+			1, &previousDispatch,
+			0, nullptr,
+			0, nullptr);
+
+		vkCmdBindDescriptorSets(
+			commandBuffer,
+			VK_PIPELINE_BIND_POINT_COMPUTE,
+			pipelineLayout,
+			0, 1,
+			&descriptorSets[frameIndex],
+			0, nullptr);
+
+		vkCmdPushConstants(
+			commandBuffer,
+			pipelineLayout,
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			0,
+			sizeof(SplineSurfacePushConstantData),
+			&push);
+
+		evaluatePipeline->bind(commandBuffer);
+		vkCmdDispatch(commandBuffer, groupCount(samples.columnEnd - samples.columnBegin), groupCount(samples.rowEnd - samples.rowBegin), 1);
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = sampleBuffer->getBuffer();
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr);
+
+		// A quad uses the samples at its corners, so the quads just before the region change as well.
+		const uint32_t quads = subdivisions - 1;
+		push.rowBegin = samples.rowBegin > 0 ? samples.rowBegin - 1 : 0;
+		push.rowEnd = std::min(samples.rowEnd, quads);
+		push.columnBegin = samples.columnBegin > 0 ? samples.columnBegin - 1 : 0;
+		push.columnEnd = std::min(samples.columnEnd, quads);
+		vkCmdPushConstants(
+			commandBuffer,
+			pipelineLayout,
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			0,
+			sizeof(SplineSurfacePushConstantData),
+			&push);
+
+		flatPipeline->bind(commandBuffer);
+		vkCmdDispatch(commandBuffer, groupCount(push.columnEnd - push.columnBegin), groupCount(push.rowEnd - push.rowBegin), 1);
+
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.buffer = model->getVertexBuffer().getBuffer();
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr);
+	}
+
+	std::vector<SplineSurfaceComputeSystem::Vertex> SplineSurfaceComputeSystem::readBack()
+	{
+		vkDeviceWaitIdle(device.device());
+
+		Buffer& vertexBuffer = model->getVertexBuffer();
+		Buffer stagingBuffer(
+			device,
+			sizeof(Vertex),
+			model->getVertexCount(),
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		device.copyBuffer(vertexBuffer.getBuffer(), stagingBuffer.getBuffer(), vertexBuffer.getBufferSize());
+
+		std::vector<Vertex> vertices(model->getVertexCount());
+		stagingBuffer.map();
+		memcpy(vertices.data(), stagingBuffer.getMappedMemory(), sizeof(Vertex) * vertices.size());
+
+		return vertices;
+	}
+
+	float SplineSurfaceComputeSystem::compareWithCpu(const std::vector<Vertex>& controlPoints)
+	{
+		vkDeviceWaitIdle(device.device());
+
+		updateControlPoints(0, controlPoints);
+		VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
+		dispatch(commandBuffer, 0);
+		device.endSingleTimeCommands(commandBuffer);
+
+		const std::vector<Vertex> gpuVertices = readBack();
+
+		const std::vector<Vertex> samples = plan->evaluate(controlPoints);
+		std::vector<Vertex> cpuVertices(gpuVertices.size());
+		SurfaceMesh::updateFlatSurface(samples, subdivisions, subdivisions, 0, subdivisions - 1, 0, subdivisions - 1, cpuVertices);
+
+		float maxDifference = 0.f;
+		for (size_t i = 0; i < cpuVertices.size(); i++)
+		{
+			const glm::vec3 position = glm::abs(gpuVertices[i].position - cpuVertices[i].position);
+			const glm::vec3 normal = glm::abs(gpuVertices[i].normal - cpuVertices[i].normal);
+			maxDifference = std::max({ maxDifference, position.x, position.y, position.z, normal.x, normal.y, normal.z });
+		}
+		return maxDifference;
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Buffer.h"
+#include "ComputePipeline.h"
+#include "DeferredReleaseQueue.h"
+#include "Descriptors.h"
+#include "Device.h"
+#include "Model.h"
+#include "SurfaceEvaluationPlan.h"
+
+#include <memory>
+#include <vector>
+
+namespace assignment
+{
+	// Evaluates a B-spline surface on the GPU straight into the vertex buffer of a flat shaded Model.
+	// The control net and the knot vectors live in storage buffers; the dispatch is recorded into
+	// the frame command buffer before the render pass, so nothing goes through the CPU per frame.
+	// After control point edits only the samples and quads inside their local support are dispatched.
+	class SplineSurfaceComputeSystem
+	{
+	public:
+		using Vertex = Model::Vertex;
+
+		// Size of the basis arrays in spline_surface.comp.
+		static constexpr uint32_t MAX_DEGREE = 7;
+
+		SplineSurfaceComputeSystem(
+			Device& device,
+			DeferredReleaseQueue& releaseQueue,
+			uint32_t rows,
+			uint32_t cols,
+			uint32_t degreeU,
+			uint32_t degreeV,
+			uint32_t subdivisions);
+		~SplineSurfaceComputeSystem();
+
+		NO_COPY(SplineSurfaceComputeSystem);
+
+	public:
+		// Recreates the knot, sample and vertex buffers together with the Model. The old ones go to the
+		// release queue, so nothing waits for the device.
+		void setParameters(uint32_t degreeU, uint32_t degreeV, uint32_t subdivisions);
+		// Writes the control net used by the next dispatch for this frame and marks the samples
+		// influenced by the control points that differ from the last net.
+		void updateControlPoints(int frameIndex, const std::vector<Vertex>& controlPoints);
+		// Records the evaluation of the marked samples, if any; must be called outside of a render pass.
+		void dispatch(VkCommandBuffer commandBuffer, int frameIndex);
+
+		// Evaluates the control net on the GPU, reads the vertices back and returns the largest
+		// position or normal difference to the CPU evaluation. Like a frame, the dispatch covers the whole
+		// surface after setParameters and otherwise only the region of the control points that changed
+		// since the last call. Blocks until the device is idle.
+		float compareWithCpu(const std::vector<Vertex>& controlPoints);
+		std::vector<Vertex> readBack();
+
+		std::shared_ptr<Model> getModel() const { return model; }
+		uint32_t getDegreeU() const { return degreeU; }
+		uint32_t getDegreeV() const { return degreeV; }
+		uint32_t getSubdivisions() const { return subdivisions; }
+
+	private:
+		void createDescriptorSetLayout();
+		void createPipelineLayout();
+		void createPipelines();
+		void createControlPointBuffers();
+		void createSurfaceBuffers();
+		void writeDescriptorSet(int frameIndex);
+
+	private:
+		Device& device;
+		DeferredReleaseQueue& releaseQueue;
+
+		uint32_t rows;
+		uint32_t cols;
+		uint32_t degreeU;
+		uint32_t degreeV;
+		uint32_t subdivisions;
+		glm::vec3 color{ 1.f };
+
+		// Local support of the control points, for the region to dispatch.
+		std::unique_ptr<SurfaceEvaluationPlan> plan;
+		// The net of the last updateControlPoints, empty while the buffers hold no evaluated surface.
+		std::vector<glm::vec4> controlPositions;
+		SurfaceEvaluationPlan::SampleRegion pendingRegion{};
+
+		std::unique_ptr<DescriptorSetLayout> setLayout;
+		std::unique_ptr<DescriptorPool> descriptorPool;
+		std::vector<VkDescriptorSet> descriptorSets;
+
+		VkPipelineLayout pipelineLayout;
+		std::unique_ptr<ComputePipeline> evaluatePipeline;
+		std::unique_ptr<ComputePipeline> flatPipeline;
+
+		std::vector<std::unique_ptr<Buffer>> controlPointBuffers;
+		std::unique_ptr<Buffer> knotBuffer;
+		std::unique_ptr<Buffer> sampleBuffer;
+		std::shared_ptr<Model> model;
+
+		// A frame's descriptor set may still be in use by its last submission, so it is only rewritten
+		// for the new buffers when that frame dispatches again.
+		std::vector<bool> descriptorSetsCurrent;
+	};
+}
@@ -0,0 +1,215 @@
+#include "SplineSurfaceTessellationSystem.h"
+
+#include "SurfaceMesh.h"
+#include "SwapChain.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace assignment
+{
+	struct TessellationPushConstantData
+	{
+		glm::mat4 modelMatrix{ 1.f };
+		glm::vec4 color{ 1.f };
+		glm::vec2 viewportSize{};
+		float pixelsPerSegment;
+		uint32_t patchCountV;
+		uint32_t knotOffsetV;
+	};
+
+	SplineSurfaceTessellationSystem::SplineSurfaceTessellationSystem(
+		Device& device,
+		VkRenderPass renderPass,
+		VkDescriptorSetLayout globalSetLayout,
+		uint32_t rows,
+		uint32_t cols,
+		const std::vector<Vertex>& controlPoints)
+		: device(device), rows(rows), cols(cols)
+	{
+		assert(rows > DEGREE && cols > DEGREE && "Bicubic patches need at least 4 x 4 control points");
+
+		createDescriptorSet();
+		createPipelineLayout(globalSetLayout);
+		createPipeline(renderPass);
+		createControlPointBuffers();
+		createPatchIndices();
+		updateControlPoints(controlPoints);
+	}
+
+	SplineSurfaceTessellationSystem::~SplineSurfaceTessellationSystem()
+	{
+		vkDestroyPipelineLayout(device.device(), pipelineLayout, nullptr);
+	}
+
+	void SplineSurfaceTessellationSystem::createDescriptorSet()
+	{
+		std::vector<float> knots = SurfaceMesh::calculateKnots(DEGREE, rows);
+		const std::vector<float> knotsV = SurfaceMesh::calculateKnots(DEGREE, cols);
+		knots.insert(knots.end(), knotsV.begin(), knotsV.end());
+
+		knotBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(float),
+			uint32_t(knots.size()),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		knotBuffer->map();
+		knotBuffer->writeToBuffer(knots.data());
+		knotBuffer->unmap();
+
+		knotSetLayout = DescriptorSetLayout::Builder(device)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT)
+			.build();
+
+		descriptorPool = DescriptorPool::Builder(device)
+			.setMaxSets(1)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1)
+			.build();
+
+		auto knotInfo = knotBuffer->descriptorInfo();
+		if (!DescriptorWriter(*knotSetLayout, *descriptorPool)
+			.writeBuffer(0, &knotInfo)
+			.build(knotDescriptorSet))
+			throw std::runtime_error("Failed to allocate knot descriptor set");
+	}
+
+	void SplineSurfaceTessellationSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout)
+	{
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(TessellationPushConstantData);
+
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ globalSetLayout, knotSetLayout->getDescriptorSetLayout() };
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = uint32_t(descriptorSetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(device.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create pipeline layout");
+	}
+
+	void SplineSurfaceTessellationSystem::createPipeline(VkRenderPass renderPass)
+	{
+		assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
+
+		PipelineConfigInfo pipelineConfig{};
+		Pipeline::tessellationPipelineConfigInfo(pipelineConfig, (DEGREE + 1) * (DEGREE + 1));
+		pipelineConfig.renderPass = renderPass;
+		pipelineConfig.pipelineLayout = pipelineLayout;
+		pipeline = std::make_unique<Pipeline>(
+			device,
+			"shaders/splinePatchVert.spv",
+			"shaders/splinePatchTesc.spv",
+			"shaders/splinePatchTese.spv",
+			"shaders/frag.spv",
+			pipelineConfig);
+	}
+
+	void SplineSurfaceTessellationSystem::createControlPointBuffers()
+	{
+		controlPointBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+		for (auto& buffer : controlPointBuffers)
+		{
+			buffer = std::make_unique<Buffer>(
+				device,
+				sizeof(Vertex),
+				rows * cols,
+				VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			buffer->map();
+		}
+		controlPointBuffersCurrent.assign(controlPointBuffers.size(), false);
+	}
+
+	void SplineSurfaceTessellationSystem::createPatchIndices()
+	{
+		// Patch (a, b) covers knot spans a + DEGREE and b + DEGREE; the tessellation evaluation
+		// shader recovers them from gl_PrimitiveID, so patches must stay in this order.
+		std::vector<uint32_t> indices;
+		for (uint32_t a = 0; a + DEGREE < rows; a++)
+			for (uint32_t b = 0; b + DEGREE < cols; b++)
+				for (uint32_t r = 0; r <= DEGREE; r++)
+					for (uint32_t c = 0; c <= DEGREE; c++)
+						indices.push_back((a + r) * cols + b + c);
+		indexCount = uint32_t(indices.size());
+
+		Buffer stagingBuffer(
+			device,
+			sizeof(uint32_t),
+			indexCount,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		stagingBuffer.map();
+		stagingBuffer.writeToBuffer(indices.data());
+
+		indexBuffer = std::make_unique<Buffer>(
+			device,
+			sizeof(uint32_t),
+			indexCount,
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		device.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), stagingBuffer.getBufferSize());
+	}
+
+	void SplineSurfaceTessellationSystem::updateControlPoints(const std::vector<Vertex>& controlPoints)
+	{
+		assert(controlPoints.size() == size_t(rows) * cols && "Control net size does not match the surface");
+
+		this->controlPoints = controlPoints;
+		controlPointBuffersCurrent.assign(controlPointBuffers.size(), false);
+		color = controlPoints[0].color;
+	}
+
+	void SplineSurfaceTessellationSystem::render(FrameInfo& frameInfo, GameObject& surfaceObject, VkExtent2D extent)
+	{
+		if (!surfaceObject.visible)
+			return;
+
+		// The frame's previous submission has completed, so its buffer can be written.
+		Buffer& controlPointBuffer = *controlPointBuffers[frameInfo.frameIndex];
+		if (!controlPointBuffersCurrent[frameInfo.frameIndex])
+		{
+			controlPointBuffer.writeToBuffer(controlPoints.data());
+			controlPointBuffersCurrent[frameInfo.frameIndex] = true;
+		}
+
+		pipeline->bind(frameInfo.commandBuffer);
+
+		VkDescriptorSet descriptorSets[] = { frameInfo.globalDescriptorSet, knotDescriptorSet };
+		vkCmdBindDescriptorSets(
+			frameInfo.commandBuffer,
+			VK_PIPELINE_BIND_POINT_GRAPHICS,
+			pipelineLayout,
+			0, 2,
+			descriptorSets,
+			0, nullptr);
+
+		TessellationPushConstantData push{};
+		push.modelMatrix = surfaceObject.transform.mat4();
+		push.color = glm::vec4(color, 1.f);
+		push.viewportSize = { float(extent.width), float(extent.height) };
+		push.pixelsPerSegment = pixelsPerSegment;
+		push.patchCountV = cols - DEGREE;
+		push.knotOffsetV = rows + DEGREE + 1;
+
+		vkCmdPushConstants(
+			frameInfo.commandBuffer,
+			pipelineLayout,
+			VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+			0,
+			sizeof(TessellationPushConstantData),
+			&push);
+
+		VkBuffer vertexBuffers[] = { controlPointBuffer.getBuffer() };
+		VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(frameInfo.commandBuffer, 0, 1, vertexBuffers, offsets);
+		vkCmdBindIndexBuffer(frameInfo.commandBuffer, indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+		vkCmdDrawIndexed(frameInfo.commandBuffer, indexCount, 1, 0, 0, 0);
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Buffer.h"
+#include "Descriptors.h"
+#include "Device.h"
+#include "FrameInfo.h"
+#include "GameObject.h"
+#include "Model.h"
+#include "Pipeline.h"
+
+#include <memory>
+#include <vector>
+
+namespace assignment
+{
+	// Draws a bicubic B-spline surface straight from its control net with hardware tessellation.
+	// Only the control points live in GPU memory; every knot span becomes one 16-point patch and
+	// the tessellation control shader picks its density from the projected size on screen.
+	// The net is drawn from a mapped vertex buffer per frame in flight, so an edit is one host write.
+	class SplineSurfaceTessellationSystem
+	{
+	public:
+		using Vertex = Model::Vertex;
+
+		static constexpr uint32_t DEGREE = 3;
+
+		SplineSurfaceTessellationSystem(
+			Device& device,
+			VkRenderPass renderPass,
+			VkDescriptorSetLayout globalSetLayout,
+			uint32_t rows,
+			uint32_t cols,
+			const std::vector<Vertex>& controlPoints);
+		~SplineSurfaceTessellationSystem();
+
+		NO_COPY(SplineSurfaceTessellationSystem);
+
+	public:
+		// The whole surface takes the color of the first control point, like the flat shaded one.
+		// Each frame copies the new net into its own buffer the next time it renders.
+		void updateControlPoints(const std::vector<Vertex>& controlPoints);
+		void render(FrameInfo& frameInfo, GameObject& surfaceObject, VkExtent2D extent);
+
+		// Target length of one tessellated segment on screen.
+		void setPixelsPerSegment(float pixels) { pixelsPerSegment = pixels; }
+		float getPixelsPerSegment() const { return pixelsPerSegment; }
+
+	private:
+		void createDescriptorSet();
+		void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
+		void createPipeline(VkRenderPass renderPass);
+		void createControlPointBuffers();
+		void createPatchIndices();
+
+	private:
+		Device& device;
+
+		uint32_t rows;
+		uint32_t cols;
+		float pixelsPerSegment = 8.f;
+		glm::vec3 color{ 1.f };
+
+		std::unique_ptr<DescriptorSetLayout> knotSetLayout;
+		std::unique_ptr<DescriptorPool> descriptorPool;
+		VkDescriptorSet knotDescriptorSet;
+		std::unique_ptr<Buffer> knotBuffer;
+
+		std::unique_ptr<Pipeline> pipeline;
+		VkPipelineLayout pipelineLayout;
+
+		// Control net as vertices, 16 indices per patch.
+		std::vector<Vertex> controlPoints;
+		std::vector<std::unique_ptr<Buffer>> controlPointBuffers;
+		std::vector<bool> controlPointBuffersCurrent;
+		std::unique_ptr<Buffer> indexBuffer;
+		uint32_t indexCount = 0;
+	};
+}
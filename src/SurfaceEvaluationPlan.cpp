@@ -0,0 +1,187 @@
+#include "SurfaceEvaluationPlan.h"
+
+#include "BSplineBasis.h"
+
+#include <algorithm>
+#include <cassert>
+#include <execution>
+#include <numeric>
+
+namespace assignment
+{
+	SurfaceEvaluationPlan::SurfaceEvaluationPlan(
+		uint32_t degreeU,
+		uint32_t degreeV,
+		const std::vector<float>& knotsU,
+		const std::vector<float>& knotsV,
+		uint32_t subdivisions)
+		: subdivisions(subdivisions),
+		rowTable(buildTable(degreeU, knotsU, subdivisions)),
+		columnTable(buildTable(degreeV, knotsV, subdivisions)),
+		rowIndices(subdivisions)
+	{
+		std::iota(rowIndices.begin(), rowIndices.end(), 0u);
+	}
+
+	bool SurfaceEvaluationPlan::matches(
+		uint32_t degreeU,
+		uint32_t degreeV,
+		const std::vector<float>& knotsU,
+		const std::vector<float>& knotsV,
+		uint32_t subdivisions) const
+	{
+		return this->subdivisions == subdivisions &&
+			rowTable.degree == degreeU &&
+			columnTable.degree == degreeV &&
+			rowTable.knots == knotsU &&
+			columnTable.knots == knotsV;
+	}
+
+	std::vector<Vertex> SurfaceEvaluationPlan::evaluate(const std::vector<Vertex>& controlPoints, bool parallel) const
+	{
+		std::vector<Vertex> result;
+		evaluate(controlPoints, result, parallel);
+		return result;
+	}
+
+	void SurfaceEvaluationPlan::evaluate(const std::vector<Vertex>& controlPoints, std::vector<Vertex>& result, bool parallel) const
+	{
+		assert(controlPoints.size() >= size_t(rowTable.controlPointCount) * columnTable.controlPointCount && "Not enough control points");
+
+		result.resize(size_t(subdivisions) * subdivisions);
+
+		if (!parallel)
+		{
+			std::vector<glm::vec3> rowCurve(columnTable.controlPointCount);
+			std::vector<glm::vec3> rowDerivative(columnTable.controlPointCount);
+			for (uint32_t i = 0; i < subdivisions; i++)
+				evaluateRow(i, controlPoints, rowCurve, rowDerivative, result.data() + size_t(i) * subdivisions, 0, subdivisions);
+			return;
+		}
+
+		// Every row writes only its own slice of the preallocated result.
+		Vertex* output = result.data();
+		std::for_each(std::execution::par, rowIndices.begin(), rowIndices.end(),
+			[&](uint32_t i)
+			{
+				std::vector<glm::vec3> rowCurve(columnTable.controlPointCount);
+				std::vector<glm::vec3> rowDerivative(columnTable.controlPointCount);
+				evaluateRow(i, controlPoints, rowCurve, rowDerivative, output + size_t(i) * subdivisions, 0, subdivisions);
+			});
+	}
+
+	SurfaceEvaluationPlan::SampleRegion SurfaceEvaluationPlan::affectedRegion(const std::vector<uint32_t>& controlPointIndices) const
+	{
+		SampleRegion region{ subdivisions, 0, subdivisions, 0 };
+		const uint32_t n = columnTable.controlPointCount;
+
+		for (uint32_t index : controlPointIndices)
+		{
+			uint32_t begin, end;
+			sampleRange(rowTable, index / n, begin, end);
+			region.rowBegin = std::min(region.rowBegin, begin);
+			region.rowEnd = std::max(region.rowEnd, end);
+
+			sampleRange(columnTable, index % n, begin, end);
+			region.columnBegin = std::min(region.columnBegin, begin);
+			region.columnEnd = std::max(region.columnEnd, end);
+		}
+
+		if (region.empty())
+			return {};
+		return region;
+	}
+
+	SurfaceEvaluationPlan::BasisTable SurfaceEvaluationPlan::buildTable(uint32_t degree, const std::vector<float>& knots, uint32_t subdivisions)
+	{
+		assert(subdivisions >= 2 && "Spline surface needs at least 2 subdivisions");
+		assert(knots.size() > degree + 1 && "Not enough knots");
+
+		BasisTable table;
+		table.degree = degree;
+		table.controlPointCount = uint32_t(knots.size()) - degree - 1;
+		table.knots = knots;
+		table.firstIndex.resize(subdivisions);
+		table.values.resize(size_t(subdivisions) * (degree + 1));
+		table.derivatives.resize(size_t(subdivisions) * (degree + 1));
+
+		for (uint32_t s = 0; s < subdivisions; s++)
+		{
+			const float u = float(s) / float(subdivisions - 1);
+			const uint32_t span = BSplineBasis::findSpan(degree, u, knots, table.controlPointCount);
+			BSplineBasis::evaluate(span, u, degree, knots, &table.values[size_t(s) * (degree + 1)], &table.derivatives[size_t(s) * (degree + 1)]);
+			table.firstIndex[s] = span - degree;
+		}
+
+		return table;
+	}
+
+	void SurfaceEvaluationPlan::sampleRange(const BasisTable& table, uint32_t controlPoint, uint32_t& begin, uint32_t& end)
+	{
+		// firstIndex never decreases along the grid, so the samples a control point
+		// contributes to (firstIndex <= controlPoint <= firstIndex + degree) are contiguous.
+		auto first = table.firstIndex.begin();
+		auto last = table.firstIndex.end();
+		begin = uint32_t(std::partition_point(first, last, [&](uint32_t f) { return f + table.degree < controlPoint; }) - first);
+		end = uint32_t(std::partition_point(first, last, [&](uint32_t f) { return f <= controlPoint; }) - first);
+	}
+
+	void SurfaceEvaluationPlan::evaluateRow(
+		uint32_t row,
+		const std::vector<Vertex>& controlPoints,
+		std::vector<glm::vec3>& rowCurve,
+		std::vector<glm::vec3>& rowDerivative,
+		Vertex* result,
+		uint32_t columnBegin,
+		uint32_t columnEnd) const
+	{
+		const uint32_t p = rowTable.degree;
+		const uint32_t q = columnTable.degree;
+		const uint32_t n = columnTable.controlPointCount;
+
+		// Contract the U direction first: the row becomes a B-spline curve in V, and its
+		// U derivative another one. Only the control columns used by [columnBegin, columnEnd) are needed.
+		const uint32_t firstU = rowTable.firstIndex[row];
+		const float* N_u = &rowTable.values[size_t(row) * (p + 1)];
+		const float* dN_u = &rowTable.derivatives[size_t(row) * (p + 1)];
+		const uint32_t controlBegin = columnTable.firstIndex[columnBegin];
+		const uint32_t controlEnd = columnTable.firstIndex[columnEnd - 1] + q + 1;
+		for (uint32_t c = controlBegin; c < controlEnd; c++)
+		{
+			glm::vec3 point{ 0.f };
+			glm::vec3 derivative{ 0.f };
+			for (uint32_t k = 0; k <= p; k++)
+			{
+				const glm::vec3& controlPoint = controlPoints[size_t(firstU + k) * n + c].position;
+				point += N_u[k] * controlPoint;
+				derivative += dN_u[k] * controlPoint;
+			}
+			rowCurve[c] = point;
+			rowDerivative[c] = derivative;
+		}
+
+		for (uint32_t j = columnBegin; j < columnEnd; j++)
+		{
+			const uint32_t firstV = columnTable.firstIndex[j];
+			const float* N_v = &columnTable.values[size_t(j) * (q + 1)];
+			const float* dN_v = &columnTable.derivatives[size_t(j) * (q + 1)];
+
+			Vertex vertex{};
+			glm::vec3 S_u{ 0.f };
+			glm::vec3 S_v{ 0.f };
+			for (uint32_t l = 0; l <= q; l++)
+			{
+				vertex.position += N_v[l] * rowCurve[firstV + l];
+				S_u += N_v[l] * rowDerivative[firstV + l];
+				S_v += dN_v[l] * rowCurve[firstV + l];
+			}
+
+			// Sv x Su faces the same way as the triangles of Model::createSmoothSurfaceFromVector.
+			const glm::vec3 normal = glm::cross(S_v, S_u);
+			const float length = glm::length(normal);
+			vertex.normal = length > 0.f ? normal / length : glm::vec3(0.f);
+			vertex.color = controlPoints[0].color;
+			result[j] = vertex;
+		}
+	}
+}
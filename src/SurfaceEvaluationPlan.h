@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Vertex.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// Basis tables of a tensor product B-spline surface sampled on a subdivisions x subdivisions grid.
+	// They depend only on the degrees, knots and sample count, so a new control net
+	// is evaluated as a sparse contraction without touching the basis functions again.
+	// The tables also hold the basis derivatives, which give every sample an exact normal.
+	class SurfaceEvaluationPlan
+	{
+	public:
+		SurfaceEvaluationPlan(
+			uint32_t degreeU,
+			uint32_t degreeV,
+			const std::vector<float>& knotsU,
+			const std::vector<float>& knotsV,
+			uint32_t subdivisions);
+
+	public:
+		bool matches(
+			uint32_t degreeU,
+			uint32_t degreeV,
+			const std::vector<float>& knotsU,
+			const std::vector<float>& knotsV,
+			uint32_t subdivisions) const;
+
+		// parallel splits the rows across cores, the result is bit-identical to the serial evaluation.
+		std::vector<Vertex> evaluate(const std::vector<Vertex>& controlPoints, bool parallel = false) const;
+		void evaluate(const std::vector<Vertex>& controlPoints, std::vector<Vertex>& result, bool parallel = false) const;
+
+		// Half-open range of grid rows and columns.
+		struct SampleRegion
+		{
+			uint32_t rowBegin = 0;
+			uint32_t rowEnd = 0;
+			uint32_t columnBegin = 0;
+			uint32_t columnEnd = 0;
+
+			bool empty() const { return rowBegin >= rowEnd || columnBegin >= columnEnd; }
+		};
+
+		// Bounding region of the samples influenced by the given control points (index = row * countV + column).
+		SampleRegion affectedRegion(const std::vector<uint32_t>& controlPointIndices) const;
+
+		uint32_t getSubdivisions() const { return subdivisions; }
+		uint32_t getControlPointCountU() const { return rowTable.controlPointCount; }
+		uint32_t getControlPointCountV() const { return columnTable.controlPointCount; }
+
+	private:
+		struct BasisTable
+		{
+			uint32_t degree = 0;
+			uint32_t controlPointCount = 0;
+			std::vector<float> knots{};
+
+			// firstIndex[s] is the first control point index with a non-zero basis at sample s,
+			// values[s * (degree + 1) + k] is the basis of control point firstIndex[s] + k
+			// and derivatives[s * (degree + 1) + k] its first derivative.
+			std::vector<uint32_t> firstIndex{};
+			std::vector<float> values{};
+			std::vector<float> derivatives{};
+		};
+
+		static BasisTable buildTable(uint32_t degree, const std::vector<float>& knots, uint32_t subdivisions);
+		static void sampleRange(const BasisTable& table, uint32_t controlPoint, uint32_t& begin, uint32_t& end);
+
+		void evaluateRow(
+			uint32_t row,
+			const std::vector<Vertex>& controlPoints,
+			std::vector<glm::vec3>& rowCurve,
+			std::vector<glm::vec3>& rowDerivative,
+			Vertex* result,
+			uint32_t columnBegin,
+			uint32_t columnEnd) const;
+
+	private:
+		uint32_t subdivisions;
+		BasisTable rowTable;
+		BasisTable columnTable;
+		std::vector<uint32_t> rowIndices;
+	};
+}
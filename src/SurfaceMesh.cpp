@@ -0,0 +1,114 @@
+#include "SurfaceMesh.h"
+
+#include "SurfaceEvaluationPlan.h"
+
+#include <cassert>
+
+namespace assignment
+{
+	std::vector<uint32_t> SurfaceMesh::smoothSurfaceIndices(uint32_t rows, uint32_t cols)
+	{
+		std::vector<uint32_t> indices;
+		indices.reserve(size_t(rows - 1) * (cols - 1) * 6);
+		for (int i = 0; i < rows - 1; i++)
+		{
+			for (int j = 0; j < cols - 1; j++)
+			{
+				indices.push_back(i * cols + j);
+				indices.push_back(i * cols + j + 1);
+				indices.push_back((i + 1) * cols + j);
+				indices.push_back(i * cols + j + 1);
+				indices.push_back((i + 1) * cols + j + 1);
+				indices.push_back((i + 1) * cols + j);
+			}
+		}
+
+		return indices;
+	}
+
+	std::vector<Vertex> SurfaceMesh::flatSurface(const std::vector<Vertex>& vertices, uint32_t rows, uint32_t cols)
+	{
+		std::vector<Vertex> flatVertices(size_t(rows - 1) * (cols - 1) * 6);
+		updateFlatSurface(vertices, rows, cols, 0, rows - 1, 0, cols - 1, flatVertices);
+		return flatVertices;
+	}
+
+	void SurfaceMesh::updateFlatSurface(
+		const std::vector<Vertex>& vertices,
+		uint32_t rows,
+		uint32_t cols,
+		uint32_t quadRowBegin,
+		uint32_t quadRowEnd,
+		uint32_t quadColBegin,
+		uint32_t quadColEnd,
+		std::vector<Vertex>& flatVertices)
+	{
+		assert(flatVertices.size() == size_t(rows - 1) * (cols - 1) * 6 && "Flat surface has a wrong vertex count");
+
+		for (uint32_t i = quadRowBegin; i < quadRowEnd; i++)
+		{
+			for (uint32_t j = quadColBegin; j < quadColEnd; j++)
+			{
+				const uint32_t indices[6] = {
+					i * cols + j,
+					i * cols + j + 1,
+					(i + 1) * cols + j,
+					i * cols + j + 1,
+					(i + 1) * cols + j + 1,
+					(i + 1) * cols + j
+				};
+
+				Vertex* quad = &flatVertices[(size_t(i) * (cols - 1) + j) * 6];
+				for (uint32_t triangleIndex = 0; triangleIndex < 6; triangleIndex += 3)
+				{
+					glm::vec3 vec1 = vertices[indices[triangleIndex]].position;
+					glm::vec3 vec2 = vertices[indices[triangleIndex + 1]].position;
+					glm::vec3 vec3 = vertices[indices[triangleIndex + 2]].position;
+
+					glm::vec3 side1 = vec2 - vec1;
+					glm::vec3 side2 = vec3 - vec1;
+					glm::vec3 triangleNormal = glm::normalize(glm::cross(side1, side2));
+
+					for (uint32_t k = triangleIndex; k < triangleIndex + 3; k++)
+					{
+						quad[k] = vertices[indices[k]];
+						quad[k].normal = triangleNormal;
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<Vertex> SurfaceMesh::calculateSplineSurface(int degreeU, int degreeV, std::vector<float>& knotsU, std::vector<float>& knotsV, std::vector<Vertex>& controlPoints, uint32_t subdivisions, bool parallel)
+	{
+		SurfaceEvaluationPlan plan(degreeU, degreeV, knotsU, knotsV, subdivisions);
+		return plan.evaluate(controlPoints, parallel);
+	}
+
+	std::vector<Vertex> SurfaceMesh::calculateBezierSurface(
+		uint32_t degreeU,
+		uint32_t degreeV,
+		const std::vector<float>& knotsU,
+		const std::vector<float>& knotsV,
+		const std::vector<Vertex>& controlPoints,
+		uint32_t subdivisions,
+		bool parallel)
+	{
+		const BezierExtraction::Surface surface = BezierExtraction::extractSurface(degreeU, degreeV, knotsU, knotsV, controlPoints);
+		return surface.evaluateGrid(subdivisions, controlPoints[0].color, parallel);
+	}
+
+	std::vector<float> SurfaceMesh::calculateKnots(uint32_t degree, int size)
+	{
+		std::vector<float> knots;
+		for (int i = 0; i < degree + 1; i++)
+			knots.push_back(0.f);
+		for (int i = degree; i < size - 1; i++)
+			knots.push_back(i - degree + 1);
+		for (int i = size; i <= size + degree; i++)
+			knots.push_back(size - degree);
+		for (auto& f : knots)
+			f /= float(size - degree);
+		return knots;
+	}
+}
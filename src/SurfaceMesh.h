@@ -0,0 +1,57 @@
+#pragma once
+
+#include "BezierExtraction.h"
+#include "Vertex.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace assignment
+{
+	// CPU side of the spline surface and the Model surface builders, without Vulkan.
+	class SurfaceMesh
+	{
+	public:
+		// Two triangles per quad of a rows x cols vertex grid.
+		static std::vector<uint32_t> smoothSurfaceIndices(uint32_t rows, uint32_t cols);
+		// Six vertices with the triangle normal per quad of a rows x cols vertex grid.
+		static std::vector<Vertex> flatSurface(const std::vector<Vertex>& vertices, uint32_t rows, uint32_t cols);
+		// Rewrites the six flat-shaded vertices of every quad in the given range of a rows x cols grid.
+		static void updateFlatSurface(
+			const std::vector<Vertex>& vertices,
+			uint32_t rows,
+			uint32_t cols,
+			uint32_t quadRowBegin,
+			uint32_t quadRowEnd,
+			uint32_t quadColBegin,
+			uint32_t quadColEnd,
+			std::vector<Vertex>& flatVertices);
+
+		static std::vector<Vertex> calculateSplineSurface(
+			int degreeU,
+			int degreeV,
+			std::vector<float>& knotsU,
+			std::vector<float>& knotsV,
+			std::vector<Vertex>& controlPoints,
+			uint32_t subdivisions = 10,
+			bool parallel = false
+		);
+
+		// Same samples as calculateSplineSurface, evaluated patch by patch from the Bezier form.
+		static std::vector<Vertex> calculateBezierSurface(
+			uint32_t degreeU,
+			uint32_t degreeV,
+			const std::vector<float>& knotsU,
+			const std::vector<float>& knotsV,
+			const std::vector<Vertex>& controlPoints,
+			uint32_t subdivisions = 10,
+			bool parallel = false
+		);
+
+		static std::vector<float> calculateKnots(uint32_t degree, int size);
+	};
+}
@@ -39,7 +39,7 @@ namespace assignment
 		{
 			vkDestroyImageView(m_device.device(), depthImageViews[i], nullptr);
 			vkDestroyImage(m_device.device(), depthImages[i], nullptr);
-			vkFreeMemory(m_device.device(), depthImageMemories[i], nullptr);
+			m_device.freeMemory(depthImageMemories[i]);
 		}
 
 		for (auto frameBuffer : swapChainFramebuffers)
@@ -66,7 +66,7 @@ namespace assignment
 		VkRenderPass renderPass;
 
 		std::vector<VkImage> depthImages;
-		std::vector<VkDeviceMemory> depthImageMemories;
+		std::vector<MemoryAllocator::Allocation> depthImageMemories;
 		std::vector<VkImageView> depthImageViews;
 		std::vector<VkImage> swapChainImages;
 		std::vector<VkImageView> swapChainImageViews;
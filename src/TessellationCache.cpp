@@ -0,0 +1,83 @@
+#include "TessellationCache.h"
+
+namespace assignment
+{
+	TessellationCache::TessellationCache(DeferredReleaseQueue& releaseQueue, VkDeviceSize budget)
+		: releaseQueue(releaseQueue), budget(budget)
+	{
+	}
+
+	std::shared_ptr<GraphicsPrimitive> TessellationCache::findPrimitive(const Key& key)
+	{
+		const auto it = lookup.find(key.hash);
+		if (it == lookup.end() || it->second->key.check != key.check)
+		{
+			statistics.misses++;
+			return nullptr;
+		}
+
+		statistics.hits++;
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->primitive;
+	}
+
+	void TessellationCache::insert(const Key& key, std::shared_ptr<GraphicsPrimitive> primitive)
+	{
+		// An entry colliding in the lookup hash is replaced as well.
+		const auto existing = lookup.find(key.hash);
+		if (existing != lookup.end())
+		{
+			const Key previous = existing->second->key;
+			erase(previous);
+		}
+
+		const VkDeviceSize size = primitive->getMemorySize();
+		if (size > budget)
+			return;
+
+		evict(budget - size);
+		entries.push_front({ key, std::move(primitive), size });
+		lookup[key.hash] = entries.begin();
+		memoryUsage += size;
+	}
+
+	void TessellationCache::erase(const Key& key)
+	{
+		const auto it = lookup.find(key.hash);
+		if (it == lookup.end() || it->second->key != key)
+			return;
+
+		memoryUsage -= it->second->size;
+		releaseQueue.retire(std::move(it->second->primitive));
+		entries.erase(it->second);
+		lookup.erase(it);
+	}
+
+	void TessellationCache::clear()
+	{
+		for (Entry& entry : entries)
+			releaseQueue.retire(std::move(entry.primitive));
+		entries.clear();
+		lookup.clear();
+		memoryUsage = 0;
+	}
+
+	void TessellationCache::setBudget(VkDeviceSize budget)
+	{
+		this->budget = budget;
+		evict(budget);
+	}
+
+	void TessellationCache::evict(VkDeviceSize target)
+	{
+		while (memoryUsage > target)
+		{
+			Entry& entry = entries.back();
+			memoryUsage -= entry.size;
+			releaseQueue.retire(std::move(entry.primitive));
+			lookup.erase(entry.key.hash);
+			entries.pop_back();
+			statistics.evictions++;
+		}
+	}
+}
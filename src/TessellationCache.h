@@ -0,0 +1,128 @@
+#pragma once
+
+#include "DeferredReleaseQueue.h"
+#include "GraphicsPrimitive.h"
+#include "utils.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace assignment
+{
+	// Least recently used cache of uploaded Lines and Models, keyed by a hash of everything
+	// their tessellation was built from. A frame in flight may still draw an entry the cache drops,
+	// so evicted, erased and replaced primitives go to the release queue instead of being freed.
+	// Every entry also stores an FNV-1a hash of the raw bytes of its inputs, independent of std::hash,
+	// so two inputs colliding in the lookup hash are told apart instead of returning a wrong tessellation.
+	class TessellationCache
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+		};
+
+		TessellationCache(DeferredReleaseQueue& releaseQueue, VkDeviceSize budget);
+
+		NO_COPY(TessellationCache);
+
+		struct Key
+		{
+			size_t hash = 0;
+			uint64_t check = 0;
+
+			bool operator==(const Key&) const = default;
+		};
+
+	public:
+		// kind tells apart primitives built from the same inputs; vectors are hashed element by element.
+		// Inputs must be trivially copyable and free of padding, since the check hash reads their bytes.
+		template<typename... Inputs>
+		static Key makeKey(std::string_view kind, const Inputs&... inputs)
+		{
+			Key key;
+			key.check = 0xcbf29ce484222325ull;
+			combine(key, kind);
+			(combine(key, inputs), ...);
+			return key;
+		}
+
+		// Counts a hit or a miss; nullptr if the key is not cached.
+		template<typename T>
+		std::shared_ptr<T> find(const Key& key)
+		{
+			return std::dynamic_pointer_cast<T>(findPrimitive(key));
+		}
+
+		// Replaces an existing entry; a primitive larger than the whole budget is not kept.
+		void insert(const Key& key, std::shared_ptr<GraphicsPrimitive> primitive);
+		void erase(const Key& key);
+		void clear();
+
+		void setBudget(VkDeviceSize budget);
+		VkDeviceSize getBudget() const { return budget; }
+		VkDeviceSize getMemoryUsage() const { return memoryUsage; }
+		size_t size() const { return entries.size(); }
+		const Statistics& getStatistics() const { return statistics; }
+
+	private:
+		struct Entry
+		{
+			Key key;
+			std::shared_ptr<GraphicsPrimitive> primitive;
+			VkDeviceSize size;
+		};
+
+		static void combineBytes(Key& key, const void* data, size_t size)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; i++)
+				key.check = (key.check ^ bytes[i]) * 0x100000001b3ull;
+		}
+
+		template<typename T>
+		static void combine(Key& key, const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Cache key inputs are hashed as raw bytes");
+			hashCombine(key.hash, value);
+			combineBytes(key, &value, sizeof(T));
+		}
+
+		static void combine(Key& key, std::string_view text)
+		{
+			combine(key, text.size());
+			hashCombine(key.hash, text);
+			combineBytes(key, text.data(), text.size());
+		}
+
+		template<typename T>
+		static void combine(Key& key, const std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Cache key inputs are hashed as raw bytes");
+			combine(key, values.size());
+			for (const T& value : values)
+				hashCombine(key.hash, value);
+			combineBytes(key, values.data(), values.size() * sizeof(T));
+		}
+
+		std::shared_ptr<GraphicsPrimitive> findPrimitive(const Key& key);
+		void evict(VkDeviceSize target);
+
+	private:
+		DeferredReleaseQueue& releaseQueue;
+		VkDeviceSize budget;
+		VkDeviceSize memoryUsage = 0;
+		Statistics statistics{};
+
+		// Most recently used first.
+		std::list<Entry> entries;
+		std::unordered_map<size_t, std::list<Entry>::iterator> lookup;
+	};
+}
@@ -0,0 +1,131 @@
+#include "ThickLinesRenderSystem.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace assignment
+{
+	namespace
+	{
+		// Two triangles per segment, generated from the vertex index.
+		constexpr uint32_t QUAD_VERTEX_COUNT = 6;
+	}
+
+	struct ThickLinePushConstantData
+	{
+		glm::mat4 modelMatrix{ 1.f };
+		glm::vec2 viewportSize{};
+		float width = 1.f;
+	};
+
+	ThickLinesRenderSystem::ThickLinesRenderSystem(Device& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
+		: device(device)
+	{
+		createPipelineLayout(globalSetLayout);
+		createPipeline(renderPass);
+	}
+
+	ThickLinesRenderSystem::~ThickLinesRenderSystem()
+	{
+		vkDestroyPipelineLayout(device.device(), pipelineLayout, nullptr);
+	}
+
+	void ThickLinesRenderSystem::render(FrameInfo& frameInfo, GameObject& lineObject, VkExtent2D extent)
+	{
+		assert(lineObject.lineBatch && "Thick lines are drawn from a line batch");
+
+		pipeline->bind(frameInfo.commandBuffer);
+
+		vkCmdBindDescriptorSets(
+			frameInfo.commandBuffer,
+			VK_PIPELINE_BIND_POINT_GRAPHICS,
+			pipelineLayout,
+			0, 1,
+			&frameInfo.globalDescriptorSet,
+			0, nullptr);
+
+		ThickLinePushConstantData push{};
+		push.modelMatrix = lineObject.transform.mat4();
+		push.viewportSize = { float(extent.width), float(extent.height) };
+		push.width = width;
+
+		vkCmdPushConstants(
+			frameInfo.commandBuffer,
+			pipelineLayout,
+			VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+			0,
+			sizeof(ThickLinePushConstantData),
+			&push);
+
+		// A segment is two vertices of the batch, so vertex ranges become instance ranges.
+		lineObject.lineBatch->bind(frameInfo.commandBuffer);
+		for (const GraphicsPrimitive::VertexRange& range : lineObject.lineBatch->getVisibleRanges())
+			vkCmdDraw(frameInfo.commandBuffer, QUAD_VERTEX_COUNT, range.count / 2, 0, range.first / 2);
+	}
+
+	void ThickLinesRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout)
+	{
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(ThickLinePushConstantData);
+
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ globalSetLayout };
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = uint32_t(descriptorSetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(device.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create pipeline layout");
+	}
+
+	void ThickLinesRenderSystem::createPipeline(VkRenderPass renderPass)
+	{
+		assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
+
+		PipelineConfigInfo pipelineConfig{};
+		Pipeline::defaultPipelineConfigInfo(pipelineConfig);
+
+		// Per instance: both ends of a segment, i.e. two consecutive vertices of the batch.
+		pipelineConfig.bindingDescriptions.resize(1);
+		pipelineConfig.bindingDescriptions[0].binding = 0;
+		pipelineConfig.bindingDescriptions[0].stride = 2 * sizeof(GraphicsPrimitive::Vertex);
+		pipelineConfig.bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+		pipelineConfig.attributeDescriptions.resize(4);
+		for (uint32_t end = 0; end < 2; end++)
+		{
+			auto& position = pipelineConfig.attributeDescriptions[2 * end];
+			position.binding = 0;
+			position.location = 2 * end;
+			position.offset = end * sizeof(GraphicsPrimitive::Vertex) + offsetof(GraphicsPrimitive::Vertex, position);
+			position.format = VK_FORMAT_R32G32B32_SFLOAT;
+
+			auto& color = pipelineConfig.attributeDescriptions[2 * end + 1];
+			color.binding = 0;
+			color.location = 2 * end + 1;
+			color.offset = end * sizeof(GraphicsPrimitive::Vertex) + offsetof(GraphicsPrimitive::Vertex, color);
+			color.format = VK_FORMAT_R32G32B32_SFLOAT;
+		}
+
+		// The edge pixels are blended by coverage; they do not write depth, so they cannot hide lines drawn later.
+		pipelineConfig.colorBlendAttachment.blendEnable = VK_TRUE;
+		pipelineConfig.colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		pipelineConfig.colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		pipelineConfig.colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		pipelineConfig.colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		pipelineConfig.depthStencilInfo.depthWriteEnable = VK_FALSE;
+
+		pipelineConfig.renderPass = renderPass;
+		pipelineConfig.pipelineLayout = pipelineLayout;
+		pipeline = std::make_unique<Pipeline>(
+			device,
+			"shaders/thickLineVert.spv",
+			"shaders/thickLineFrag.spv",
+			pipelineConfig);
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Device.h"
+#include "FrameInfo.h"
+#include "GameObject.h"
+#include "Pipeline.h"
+
+#include <memory>
+#include <vector>
+
+namespace assignment
+{
+	// Draws the segments of a LineBatch at any width in pixels without the wideLines feature. Every segment is
+	// one instance read straight from the batch's vertex buffer; the vertex shader spans a screen aligned quad
+	// over it and the fragment shader keeps the pixels within half the width of the segment, which rounds the
+	// ends (and so the joins of connected segments) and fades the last pixel for anti-aliasing.
+	class ThickLinesRenderSystem
+	{
+	public:
+		ThickLinesRenderSystem(Device& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+		~ThickLinesRenderSystem();
+
+		NO_COPY(ThickLinesRenderSystem);
+
+	public:
+		// Draws the visible groups of lineObject.lineBatch; lineObject.visible is left to the caller.
+		void render(FrameInfo& frameInfo, GameObject& lineObject, VkExtent2D extent);
+
+		void setWidth(float pixels) { width = pixels; }
+		float getWidth() const { return width; }
+
+	private:
+		void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
+		void createPipeline(VkRenderPass renderPass);
+
+	private:
+		Device& device;
+
+		float width = 3.f;
+
+		std::unique_ptr<Pipeline> pipeline;
+		VkPipelineLayout pipelineLayout;
+	};
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "utils.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/glm.hpp"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+namespace assignment
+{
+	// Vertex layout shared by every primitive. Kept free of Vulkan so the CPU geometry code builds without it;
+	// the vertex input descriptions live in GraphicsPrimitive.
+	struct Vertex {
+		glm::vec3 position{};
+		glm::vec3 color{};
+		glm::vec3 normal{};
+		glm::vec2 uv{};
+
+		bool operator ==(const Vertex& other) const
+		{
+			return position == other.position &&
+				color == other.color &&
+				normal == other.normal &&
+				uv == other.uv;
+		}
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<assignment::Vertex> {
+		size_t operator()(assignment::Vertex const& vertex) const
+		{
+			size_t seed = 0;
+			assignment::hashCombine(
+				seed,
+				vertex.position,
+				vertex.color,
+				vertex.normal,
+				vertex.uv
+			);
+			return seed;
+		}
+	};
+}
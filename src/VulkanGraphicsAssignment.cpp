@@ -3,13 +3,17 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
-int main()
+int main(int argc, char** argv)
 {
 	assignment::Application app;
 
 	try
 	{
+		if (argc > 1 && std::string(argv[1]) == "--verify-surface")
+			return app.verifySplineSurface() ? EXIT_SUCCESS : EXIT_FAILURE;
+
 		app.run();
 	}
 	catch (std::exception& err)